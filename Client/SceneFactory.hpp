@@ -8,7 +8,10 @@ class SceneFactory {
 
     public:
 
-        static std::shared_ptr<Body> CreateCarpet(std::shared_ptr<Scene> scene, std::shared_ptr<ShadowRenderer> renderer, Solver &solver, int resolution, glm::vec3 position, glm::vec3 rotation, glm::vec3 scale)
+        /**
+        * @brief A renderResolution above resolution draws a finer plane embedded in the simulated one.
+        */
+        static std::shared_ptr<Body> CreateCarpet(std::shared_ptr<Scene> scene, std::shared_ptr<ShadowRenderer> renderer, Solver &solver, int resolution, glm::vec3 position, glm::vec3 rotation, glm::vec3 scale, int renderResolution = 0)
         {
             auto material = std::make_shared<PBRMaterial>(scene);
 
@@ -30,38 +33,81 @@ class SceneFactory {
 
             auto body = std::make_shared<SoftBody>(mesh, 1.0f, 0.1f, 0.01f);
 
+            if (renderResolution > resolution) {
+                auto renderMesh = MeshPrimitives::Plane("Carpet", *scene, renderResolution);
+
+                renderMesh->Transform()->Position = position;
+                renderMesh->Transform()->Rotation = rotation;
+                renderMesh->Transform()->Scale    = scale;
+                renderMesh->SetMaterial(material);
+
+                renderer->AddShadowCaster(renderMesh);
+
+                body->SetRenderMesh(renderMesh);
+            }
+
 			solver.AddBody(body);
 
             return body;
         }
 
-        static std::shared_ptr<Body> CreateSphere(std::shared_ptr<Scene> scene, std::shared_ptr<ShadowRenderer> renderer, Solver& solver, glm::vec3 position, glm::vec3 scale, glm::vec3 color, float mass)
+        /**
+        * @brief Spheres of one scale and mass may share bodyTemplate, only the first one building it.
+        */
+        static std::shared_ptr<Body> CreateSphere(std::shared_ptr<Scene> scene, std::shared_ptr<ShadowRenderer> renderer, Solver& solver, glm::vec3 position, glm::vec3 scale, glm::vec3 color, float mass, std::shared_ptr<BodyTemplate> bodyTemplate = nullptr)
         {
-            auto material = std::make_shared<PBRMaterial>(scene);
-
-            material->AlbedoColor = color;
-            material->Metallic    = 0.2f;
-            material->Roughness   = 0.6f;
-            material->SetAlbedoTexture(new Texture("../../Assets/Textures/earth.jpg"));
-            material->SetBackFaceCullingEnabled(true);
-            material->ReceiveShadows(renderer);
-
             auto mesh = MeshPrimitives::ICOSphere("Sphere", *scene, 4);
 
             mesh->Transform()->Position = position;
             mesh->Transform()->Scale    = scale;
-            mesh->SetMaterial(material);
+            mesh->SetMaterial(CreateSphereMaterial(scene, renderer, color));
             mesh->SetPickingEnabled(true);
 
             renderer->AddShadowCaster(mesh);
 
-            auto body = std::make_shared<SoftBody>(mesh, mass, 1.0f, 1.0f);
+            auto body = std::make_shared<SoftBody>(mesh, mass, 1.0f, 1.0f, BENDING_FAST, STRETCH_DISTANCE, glm::vec3(1.0f), bodyTemplate);
 
             solver.AddBody(body);
 
             return body;
         }
 
+        /**
+        * @brief Spheres like CreateSphere's, spawned at runtime from one icosphere and one template.
+        */
+        static std::shared_ptr<BodyPool> CreateSpherePool(std::shared_ptr<Scene> scene, std::shared_ptr<ShadowRenderer> renderer, Solver& solver, glm::vec3 scale, glm::vec3 color, float mass, std::size_t nbSpheresAhead = 8)
+        {
+            auto material = CreateSphereMaterial(scene, renderer, color);
+
+            auto prototype = MeshPrimitives::ICOSphere("Sphere", *scene, 4);
+            auto vertex    = std::make_shared<Vertex>(prototype->GetVertex());
+
+            scene->RemoveMesh(prototype);
+
+            auto bodyTemplate = std::make_shared<BodyTemplate>();
+
+            auto makeMesh = [=]() {
+                Vertex sphereVertex = *vertex;
+
+                auto mesh = Mesh::FromVertex("Sphere", sphereVertex);
+
+                mesh->Transform()->Scale = scale;
+                mesh->SetMaterial(material);
+                mesh->SetPickingEnabled(true);
+
+                scene->AddMesh(mesh);
+                renderer->AddShadowCaster(mesh);
+
+                return mesh;
+            };
+
+            auto makeBody = [=](std::shared_ptr<Mesh> mesh) -> std::shared_ptr<Body> {
+                return std::make_shared<SoftBody>(mesh, mass, 1.0f, 1.0f, BENDING_FAST, STRETCH_DISTANCE, glm::vec3(1.0f), bodyTemplate);
+            };
+
+            return std::make_shared<BodyPool>(solver, makeMesh, makeBody, nbSpheresAhead);
+        }
+
         static std::shared_ptr<Mesh> CreateGround(std::shared_ptr<Scene> scene, std::shared_ptr<ShadowRenderer> renderer, Solver &solver)
         {
             auto material = std::make_shared<PBRMaterial>(scene);
@@ -79,10 +125,25 @@ class SceneFactory {
             ground->SetPickingEnabled(false);
             ground->SetMaterial(material);
 
-            auto body = std::make_shared<RigidBody>(ground, 0.0f);
-
-            solver.AddBody(body);
+            // The mesh is only drawn, the solver sees the ground as a plane.
+            solver.AddCollider(std::make_shared<PlaneCollider>(ground->Transform()->Position, glm::vec3(0.0f, 1.0f, 0.0f)));
 
             return ground;
         }
+
+    private:
+
+        static std::shared_ptr<PBRMaterial> CreateSphereMaterial(std::shared_ptr<Scene> scene, std::shared_ptr<ShadowRenderer> renderer, glm::vec3 color)
+        {
+            auto material = std::make_shared<PBRMaterial>(scene);
+
+            material->AlbedoColor = color;
+            material->Metallic    = 0.2f;
+            material->Roughness   = 0.6f;
+            material->SetAlbedoTexture(new Texture("../../Assets/Textures/earth.jpg"));
+            material->SetBackFaceCullingEnabled(true);
+            material->ReceiveShadows(renderer);
+
+            return material;
+        }
 };
@@ -87,6 +87,16 @@ void SoftBodySimulationApp::InitUI()
 
 		ImGui::Checkbox("Fixed time step", &_FixedTimeStep);
 
+		bool deterministic = ThreadPool::Get().IsDeterministic();
+
+		if (ImGui::Checkbox("Deterministic", &deterministic))
+			ThreadPool::Get().SetDeterministic(deterministic);
+
+		bool fastDihedralAngle = Settings::DIHEDRAL_ANGLE_PRECISION == ANGLE_PRECISION_FAST;
+
+		if (ImGui::Checkbox("Fast dihedral angle", &fastDihedralAngle))
+			Settings::DIHEDRAL_ANGLE_PRECISION = fastDihedralAngle ? ANGLE_PRECISION_FAST : ANGLE_PRECISION_EXACT;
+
 		if (_Play && ImGui::Button("Stop"))
 			_Play = false;
 		if (!_Play && ImGui::Button("Play"))
@@ -104,6 +114,15 @@ void SoftBodySimulationApp::InitUI()
 
 			if (ImGui::Checkbox("Wireframe", &wireframe))
 				_SelectedBody->GetMesh()->GetMaterial()->SetWireframe(wireframe);
+
+			float shapeMatchingStiffness = _SelectedBody->GetShapeMatchingStiffness();
+
+			if (ImGui::SliderFloat("Shape matching", &shapeMatchingStiffness, 0.0f, 1.0f))
+				_SelectedBody->SetShapeMatching(shapeMatchingStiffness, _SelectedBody->GetShapeMatchingRings());
+			float tearingStrain = _SelectedBody->GetTearingStrain();
+
+			if (_SelectedBody->CanTear() && ImGui::SliderFloat("Tearing strain", &tearingStrain, 0.0f, 2.0f))
+				_SelectedBody->SetTearing(tearingStrain);
 		}
 
 		if (_SelectedBody != nullptr && _SelectedBody->GetGlobalVolumeConstraints().size() > 0) {
@@ -111,6 +130,8 @@ void SoftBodySimulationApp::InitUI()
 				_SelectedBody->GetGlobalVolumeConstraints()[0]->SetPressure(_CurrentBodyPressure);
 		}
 
+		ImGui::Checkbox("Sphere rain", &_IsSphereRaining);
+
 		if (ImGui::Checkbox("Gravity", &_HasGravity)) {
 			if (_HasGravity) {
 				_GravityField = std::make_shared<UniformAccelerationField>(glm::vec3(0.0f, -9.81f, 0.0f));
@@ -157,9 +178,38 @@ void SoftBodySimulationApp::UpdatePhysics(float deltaTime)
 {
 	if (!_Play)
 		return;
+	UpdateSphereRain();
+
 	_Solver.Solve(_FixedTimeStep ? 1.0f / 60.0f : deltaTime);
 }
 
+void SoftBodySimulationApp::UpdateSphereRain()
+{
+	if (!_IsSphereRaining && _SphereRainBodies.empty())
+		return;
+	if (_SphereRainPool == nullptr)
+		_SphereRainPool = SceneFactory::CreateSpherePool(_Scene, _Renderer, _Solver, glm::vec3(0.5f), { 0.3f, 0.5f, 0.9f }, 1.0f);
+	float time = _Engine->GetElapsedSeconds();
+
+	while (!_SphereRainBodies.empty() && time - _SphereRainBodies.front().second > SPHERE_RAIN_LIFETIME) {
+		_SphereRainPool->Despawn(_SphereRainBodies.front().first);
+		_SphereRainBodies.pop_front();
+	}
+
+	if (!_IsSphereRaining || time - _LastSphereRainSpawn < SPHERE_RAIN_INTERVAL)
+		return;
+	std::uniform_real_distribution<float> distribution(-5.0f, 5.0f);
+
+	glm::vec3 position = { distribution(_SphereRainRandom), 12.0f, distribution(_SphereRainRandom) };
+
+	// None ready yet: the next frame tries again.
+	if (auto body = _SphereRainPool->Spawn(position)) {
+		_SphereRainBodies.push_back({ body, time });
+
+		_LastSphereRainSpawn = time;
+	}
+}
+
 void SoftBodySimulationApp::UpdateLighting()
 {
 	if (!_Sun)
@@ -174,7 +224,10 @@ void SoftBodySimulationApp::UpdateLighting()
 void SoftBodySimulationApp::HandleDragging()
 {
 	if (!_Engine->IsMousePressed()) {
-		_IsDragging = false;
+		if (_DragAttachment != nullptr)
+			_SelectedBody->RemoveAttachment(_DragAttachment);
+		_IsDragging     = false;
+		_DragAttachment = nullptr;
 	} else if (_Engine->IsKeyPressed(GLFW_KEY_LEFT_SHIFT)) {
 		glm::vec3 rayOrigin     = _Camera->Position;
 		glm::vec2 mousePosition = _Engine->GetMousePosition();
@@ -198,33 +251,13 @@ void SoftBodySimulationApp::HandleDragging()
 
 				_IsDragging   = true;
 				_DragDistance = glm::length(hitPoint - rayOrigin);
-				_DraggedFace  = pickResult.second.FaceIndex;
-			}
-		} else if (_SelectedBody != nullptr) {
-			int index0 = _SelectedBody->GetMesh()->GetVertex().Indices[_DraggedFace * 3];
-			int index1 = _SelectedBody->GetMesh()->GetVertex().Indices[_DraggedFace * 3 + 1];
-			int index2 = _SelectedBody->GetMesh()->GetVertex().Indices[_DraggedFace * 3 + 2];
-
-			std::shared_ptr<Particle> particle0 = _SelectedBody->GetParticles()[index0];
-			std::shared_ptr<Particle> particle1 = _SelectedBody->GetParticles()[index1];
-			std::shared_ptr<Particle> particle2 = _SelectedBody->GetParticles()[index2];
-
-			glm::vec3 t0 = particle0->Position;
-			glm::vec3 t1 = particle1->Position;
-			glm::vec3 t2 = particle2->Position;
 
-			glm::vec3 baryCenter  = (t0 + t1 + t2) / 3.0f;
-			glm::vec3 hitPoint    = rayOrigin + rayDirection * _DragDistance;
-			glm::vec3 translation = hitPoint - baryCenter;
-
-			for (const auto& particle : _SelectedBody->GetParticles()) {
-				float weight = 1.0f / (1.0f + glm::length(particle->Position - baryCenter));
-
-				particle->Position += translation * weight;
+				// The particles around the hit point follow the mouse through the solver.
+				if (_SelectedBody != nullptr && _SelectedBody->GetMesh() == pickResult.first && !_SelectedBody->IsStatic())
+					_DragAttachment = _SelectedBody->Attach(hitPoint, _DragRadius, _DragCompliance);
 			}
-
-			_SelectedBody->GetMesh()->GetVertex().ComputeNormals();
-			_SelectedBody->GetMesh()->SendVertexDataToGPU();
+		} else if (_DragAttachment != nullptr) {
+			_DragAttachment->SetTarget(rayOrigin + rayDirection * _DragDistance);
 		}
 	}
 }
@@ -3,7 +3,9 @@
 #include "Exodia.hpp"
 #include "Client/OrbitCamera.hpp"
 
+#include <deque>
 #include <memory>
+#include <random>
 
 using namespace Exodia;
 
@@ -26,6 +28,7 @@ class SoftBodySimulationApp {
         void InitCallbacks();
         void InitPhysics();
         void UpdatePhysics(float deltaTime);
+        void UpdateSphereRain();
         void UpdateLighting();
         void HandleDragging();
 
@@ -77,11 +80,24 @@ class SoftBodySimulationApp {
         bool  _FixedTimeStep       = true;
         bool  _IsDragging          = false;
 		bool  _HasGravity          = true;
-        int   _DraggedFace         = -1;
         float _DragDistance        = 0.0f;
+        float _DragRadius          = 1.0f;
+        float _DragCompliance      = 0.001f;
         float _CurrentBodyPressure = 1.0f;
 
-        std::shared_ptr<Body> _SelectedBody = nullptr;
+        std::shared_ptr<Body>                 _SelectedBody   = nullptr;
+        std::shared_ptr<AttachmentConstraint> _DragAttachment = nullptr;
 
         std::shared_ptr<UniformAccelerationField> _GravityField = nullptr;
+
+        // Sphere rain: spheres spawned from a pool over the ground, back to it after a while.
+        bool  _IsSphereRaining     = false;
+        float _LastSphereRainSpawn = 0.0f;
+
+        std::shared_ptr<BodyPool>                          _SphereRainPool = nullptr;
+        std::deque<std::pair<std::shared_ptr<Body>, float>> _SphereRainBodies;
+        std::mt19937                                       _SphereRainRandom;
+
+        static constexpr float SPHERE_RAIN_INTERVAL = 0.2f;
+        static constexpr float SPHERE_RAIN_LIFETIME = 8.0f;
 };
@@ -8,7 +8,12 @@
 
 #include "Mesh/Primitives/MeshPrimitives.hpp"
 #include "Mesh/Primitives/ScreenQuad.hpp"
+#include "Mesh/Decimator.hpp"
 #include "Mesh/Mesh.hpp"
+#include "Mesh/Ordering.hpp"
+#include "Mesh/Tetrahedralizer.hpp"
+#include "Mesh/Topology.hpp"
+#include "Mesh/TornTopology.hpp"
 #include "Mesh/Vertex.hpp"
 
 #include "Renderer/Camera/Camera.hpp"
@@ -27,27 +32,45 @@
 #include "Renderer/PostProcessing.hpp"
 
 #include "Physics/Constraints/Constraint.hpp"
+#include "Physics/Constraints/AttachmentConstraint.hpp"
 #include "Physics/Constraints/CollisionConstraint.hpp"
+#include "Physics/Constraints/ConstraintBatch.hpp"
 #include "Physics/Constraints/DihedralBendConstraint.hpp"
 #include "Physics/Constraints/DistanceConstraint.hpp"
 #include "Physics/Constraints/FastBendConstraint.hpp"
 #include "Physics/Constraints/FixedConstraint.hpp"
 #include "Physics/Constraints/GlobalVolumeConstraint.hpp"
+#include "Physics/Constraints/IsometricBendConstraint.hpp"
+#include "Physics/Constraints/RigidContactConstraint.hpp"
+#include "Physics/Constraints/ShapeMatchingConstraint.hpp"
+#include "Physics/Constraints/TetherConstraint.hpp"
+#include "Physics/Constraints/TriangleStrainConstraint.hpp"
 #include "Physics/Constraints/VolumeConstraint.hpp"
 
 #include "Physics/Particle/Particle.hpp"
 
 #include "Physics/Force/UniformAccelerationField.hpp"
 
+#include "Physics/Colliders/Collider.hpp"
+#include "Physics/Colliders/BoxCollider.hpp"
+#include "Physics/Colliders/CapsuleCollider.hpp"
+#include "Physics/Colliders/PlaneCollider.hpp"
+#include "Physics/Colliders/SDFCollider.hpp"
+#include "Physics/Colliders/SphereCollider.hpp"
+
 #include "Physics/Bodies/Body.hpp"
 #include "Physics/Bodies/RigidBody.hpp"
 #include "Physics/Bodies/SoftBody.hpp"
+#include "Physics/Bodies/TetrahedralBody.hpp"
 
 #include "Physics/Solver/Solver.hpp"
+#include "Physics/Solver/BodyPool.hpp"
 
 #include "Scene/Scene.hpp"
 
 #include "Ray/PickResult.hpp"
 
+#include "Utils/ThreadPool.hpp"
+
 #include "Engine.hpp"
 #include "Settings.hpp"
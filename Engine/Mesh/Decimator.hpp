@@ -0,0 +1,285 @@
+#pragma once
+
+#include "Topology.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <queue>
+#include <tuple>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Quadric error decimation of a triangle list, keeping vertices of the input so that the result indexes it as is.
+    */
+    class Decimator {
+
+        public:
+
+            /**
+            * @brief Triangles left once decimated to at most nbTargetTriangles, when collapses allow it, in the order of the input.
+            */
+            static std::vector<int> Decimate(const std::vector<glm::vec3> &positions, const std::vector<int> &triangles, std::size_t nbTargetTriangles)
+            {
+                Decimator decimator(positions, triangles);
+
+                decimator.Collapse(nbTargetTriangles);
+
+                std::vector<int> decimatedTriangles;
+
+                for (std::size_t t = 0; t < decimator._Triangles.size(); t++)
+                    if (!decimator._IsRemoved[t])
+                        decimatedTriangles.insert(decimatedTriangles.end(), decimator._Triangles[t].begin(), decimator._Triangles[t].end());
+                return decimatedTriangles;
+            }
+
+        private:
+
+            /**
+            * @brief Symmetric 4x4 matrix of a sum of squared distances to planes, its upper triangle row by row.
+            */
+            struct Quadric {
+
+                std::array<double, 10> Coefficients {};
+
+                static Quadric FromPlane(glm::dvec3 normal, double offset, double weight)
+                {
+                    double a = normal.x, b = normal.y, c = normal.z, d = offset;
+
+                    return { { weight * a * a, weight * a * b, weight * a * c, weight * a * d, weight * b * b, weight * b * c, weight * b * d, weight * c * c, weight * c * d, weight * d * d } };
+                }
+
+                Quadric &operator+=(const Quadric &other)
+                {
+                    for (std::size_t i = 0; i < Coefficients.size(); i++)
+                        Coefficients[i] += other.Coefficients[i];
+                    return *this;
+                }
+
+                double Error(glm::dvec3 p) const
+                {
+                    const auto& q = Coefficients;
+
+                    return q[0] * p.x * p.x + 2.0 * q[1] * p.x * p.y + 2.0 * q[2] * p.x * p.z + 2.0 * q[3] * p.x
+                         + q[4] * p.y * p.y + 2.0 * q[5] * p.y * p.z + 2.0 * q[6] * p.y
+                         + q[7] * p.z * p.z + 2.0 * q[8] * p.z
+                         + q[9];
+                }
+            };
+
+            /**
+            * @brief Collapse of From onto To, valid as long as both ends are at the versions it was costed with.
+            */
+            struct Candidate {
+
+                double Error;
+                int    From;
+                int    To;
+                int    FromVersion;
+                int    ToVersion;
+
+                bool operator>(const Candidate &other) const
+                {
+                    return std::tie(Error, From, To) > std::tie(other.Error, other.From, other.To);
+                }
+            };
+
+            Decimator(const std::vector<glm::vec3> &positions, const std::vector<int> &triangles) : _Positions(positions), _Quadrics(positions.size()), _Versions(positions.size(), 0), _IsAlive(positions.size(), true), _IsBoundary(positions.size(), false), _TrianglesPerVertex(positions.size())
+            {
+                Topology topology(triangles, positions.size());
+
+                _Triangles.resize(triangles.size() / 3);
+                _IsRemoved.assign(_Triangles.size(), false);
+
+                for (std::size_t t = 0; t < _Triangles.size(); t++) {
+                    _Triangles[t] = { triangles[3 * t], triangles[3 * t + 1], triangles[3 * t + 2] };
+
+                    glm::dvec3 p0(positions[triangles[3 * t]]), p1(positions[triangles[3 * t + 1]]), p2(positions[triangles[3 * t + 2]]);
+                    glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+
+                    double area = 0.5 * glm::length(normal);
+
+                    if (area < 1e-20)
+                        continue;
+                    normal = glm::normalize(normal);
+
+                    Quadric quadric = Quadric::FromPlane(normal, -glm::dot(normal, p0), area);
+
+                    for (int k = 0; k < 3; k++)
+                        _Quadrics[triangles[3 * t + k]] += quadric;
+                }
+
+                for (std::size_t v = 0; v < positions.size(); v++)
+                    for (int c = topology.CornerOffsets[v]; c < topology.CornerOffsets[v + 1]; c++)
+                        _TrianglesPerVertex[v].push_back(topology.Corners[c] / 3);
+                for (std::size_t e = 0; e < topology.Edges.size(); e++) {
+                    if (topology.NumberOfHalfEdges(e) != 1)
+                        continue;
+                    int halfEdge = topology.HalfEdges[topology.EdgeOffsets[e]];
+
+                    glm::dvec3 p0(positions[triangles[halfEdge]]), p1(positions[triangles[Topology::Next(halfEdge)]]), p2(positions[triangles[Topology::Previous(halfEdge)]]);
+                    glm::dvec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+                    glm::dvec3 normal     = glm::cross(p1 - p0, faceNormal);
+
+                    _IsBoundary[triangles[halfEdge]]                 = true;
+                    _IsBoundary[triangles[Topology::Next(halfEdge)]] = true;
+
+                    if (glm::length(normal) < 1e-20)
+                        continue;
+                    normal = glm::normalize(normal);
+
+                    Quadric quadric = Quadric::FromPlane(normal, -glm::dot(normal, p0), BOUNDARY_WEIGHT * glm::dot(p1 - p0, p1 - p0));
+
+                    _Quadrics[triangles[halfEdge]]                 += quadric;
+                    _Quadrics[triangles[Topology::Next(halfEdge)]] += quadric;
+                }
+
+                for (const auto& edge : topology.Edges)
+                    PushEdge(edge[0], edge[1]);
+            }
+
+            void Collapse(std::size_t nbTargetTriangles)
+            {
+                std::size_t nbTriangles = _Triangles.size();
+
+                while (nbTriangles > nbTargetTriangles && !_Candidates.empty()) {
+                    Candidate candidate = _Candidates.top();
+
+                    _Candidates.pop();
+
+                    if (!_IsAlive[candidate.From] || !_IsAlive[candidate.To] || _Versions[candidate.From] != candidate.FromVersion || _Versions[candidate.To] != candidate.ToVersion)
+                        continue;
+                    if (!IsCollapsible(candidate.From, candidate.To))
+                        continue;
+                    nbTriangles -= CollapseEdge(candidate.From, candidate.To);
+                }
+            }
+
+            /**
+            * @brief Queues the collapses of edge (a, b) both ways, the second one being tried when the first is not allowed.
+            */
+            void PushEdge(int a, int b)
+            {
+                if (a == b)
+                    return;
+                Quadric quadric = _Quadrics[a];
+
+                quadric += _Quadrics[b];
+
+                // The edge length breaks ties where the surface is flat.
+                double lengthSquared = glm::dot(glm::dvec3(_Positions[a] - _Positions[b]), glm::dvec3(_Positions[a] - _Positions[b]));
+                double regularization = LENGTH_WEIGHT * lengthSquared * lengthSquared;
+
+                _Candidates.push({ quadric.Error(glm::dvec3(_Positions[b])) + regularization, a, b, _Versions[a], _Versions[b] });
+                _Candidates.push({ quadric.Error(glm::dvec3(_Positions[a])) + regularization, b, a, _Versions[b], _Versions[a] });
+            }
+
+            std::vector<int> Neighbors(int vertex) const
+            {
+                std::vector<int> neighbors;
+
+                for (int t : _TrianglesPerVertex[vertex])
+                    for (int other : _Triangles[t])
+                        if (other != vertex && std::find(neighbors.begin(), neighbors.end(), other) == neighbors.end())
+                            neighbors.push_back(other);
+                return neighbors;
+            }
+
+            bool IsCollapsible(int from, int to) const
+            {
+                std::vector<int> toNeighbors = Neighbors(to);
+
+                std::size_t nbSharedNeighbors = 0;
+                std::size_t nbSharedTriangles = 0;
+
+                for (int neighbor : Neighbors(from))
+                    if (neighbor != to && std::find(toNeighbors.begin(), toNeighbors.end(), neighbor) != toNeighbors.end())
+                        nbSharedNeighbors++;
+                for (int t : _TrianglesPerVertex[from]) {
+                    const auto& triangle = _Triangles[t];
+
+                    if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                        nbSharedTriangles++;
+
+                        continue;
+                    }
+
+                    glm::vec3 p[3], q[3];
+
+                    for (int k = 0; k < 3; k++) {
+                        p[k] = _Positions[triangle[k]];
+                        q[k] = triangle[k] == from ? _Positions[to] : p[k];
+                    }
+
+                    glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                    glm::vec3 after  = glm::cross(q[1] - q[0], q[2] - q[0]);
+
+                    if (glm::dot(before, after) <= 0.0f)
+                        return false;
+                }
+
+                if (_IsBoundary[from] && _IsBoundary[to] && nbSharedTriangles != 1)
+                    return false;  // An inner edge between two borders: the collapse would join them.
+                return nbSharedNeighbors == nbSharedTriangles && nbSharedTriangles > 0;
+            }
+
+            /**
+            * @brief Moves the triangles of from to to, removing those of the edge, and returns how many were removed.
+            */
+            std::size_t CollapseEdge(int from, int to)
+            {
+                std::size_t nbRemoved = 0;
+
+                for (int t : _TrianglesPerVertex[from]) {
+                    auto& triangle = _Triangles[t];
+
+                    if (triangle[0] == to || triangle[1] == to || triangle[2] == to) {
+                        _IsRemoved[t] = true;
+
+                        for (int vertex : triangle)
+                            if (vertex != from)
+                                std::erase(_TrianglesPerVertex[vertex], t);
+                        nbRemoved++;
+
+                        continue;
+                    }
+
+                    for (int& vertex : triangle)
+                        if (vertex == from)
+                            vertex = to;
+                    _TrianglesPerVertex[to].push_back(t);
+                }
+
+                _TrianglesPerVertex[from].clear();
+                _IsAlive[from] = false;
+                _IsBoundary[to] = _IsBoundary[to] || _IsBoundary[from];
+                _Quadrics[to] += _Quadrics[from];
+                _Versions[to]++;
+
+                for (int neighbor : Neighbors(to))
+                    PushEdge(to, neighbor);
+                return nbRemoved;
+            }
+
+        private:
+
+            static constexpr double BOUNDARY_WEIGHT = 1000.0;
+            static constexpr double LENGTH_WEIGHT   = 1e-3;
+
+            const std::vector<glm::vec3> &_Positions;
+
+            std::vector<std::array<int, 3>> _Triangles;
+            std::vector<bool>               _IsRemoved;
+
+            std::vector<Quadric>          _Quadrics;
+            std::vector<int>              _Versions;
+            std::vector<bool>             _IsAlive;
+            std::vector<bool>             _IsBoundary;
+            std::vector<std::vector<int>> _TrianglesPerVertex;
+
+            std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> _Candidates;
+    };
+};
@@ -28,6 +28,8 @@ namespace Exodia {
 
         _AABB.UpdateWithVertex(_Vertex, world);
 
+        if (!Visible)
+            return;
         Shader *shader = shaderOverride == nullptr ? _Material->GetShader() : shaderOverride;
 
         if (shaderOverride == nullptr)
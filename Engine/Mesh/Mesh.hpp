@@ -96,6 +96,7 @@ namespace Exodia {
         public:
 
             bool Enabled = true;
+            bool Visible = true;  // A hidden mesh still has its bounding box kept up to date, for the collisions.
 
         protected:
     
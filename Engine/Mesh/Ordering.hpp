@@ -0,0 +1,163 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Orders keeping neighbors close, each given as the original indices in their new order.
+    */
+    class Ordering {
+
+        public:
+
+            /**
+            * @brief The first nbPoints points sorted along a Morton curve over their bounds, ties kept in their order.
+            */
+            template<typename Point>
+            static std::vector<int> Morton(const std::vector<Point> &points, std::size_t nbPoints)
+            {
+                glm::dvec3 lower(std::numeric_limits<double>::max()), upper(std::numeric_limits<double>::lowest());
+
+                for (std::size_t i = 0; i < nbPoints; i++) {
+                    lower = glm::min(lower, glm::dvec3(points[i]));
+                    upper = glm::max(upper, glm::dvec3(points[i]));
+                }
+
+                glm::dvec3 scale = 1023.0 / glm::max(upper - lower, glm::dvec3(1e-12));
+
+                std::vector<std::uint32_t> codes(nbPoints, 0);
+                std::vector<int>           order(nbPoints);
+
+                for (std::size_t i = 0; i < nbPoints; i++) {
+                    glm::uvec3 cell = glm::uvec3((glm::dvec3(points[i]) - lower) * scale);
+
+                    for (std::uint32_t bit = 0; bit < 10; bit++)
+                        for (int k = 0; k < 3; k++)
+                            codes[i] |= ((cell[k] >> bit) & 1u) << (3 * bit + k);
+                }
+
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return codes[a] < codes[b]; });
+
+                return order;
+            }
+
+            /**
+            * @brief Reverse Cuthill-McKee order of a graph, each component starting from a pseudo-peripheral node.
+            */
+            static std::vector<int> ReverseCuthillMcKee(const std::vector<std::vector<int>> &neighbors)
+            {
+                std::size_t nbNodes = neighbors.size();
+
+                std::vector<int>  order;
+                std::vector<bool> isVisited(nbNodes, false);
+                std::vector<int>  levels(nbNodes, -1);
+
+                order.reserve(nbNodes);
+
+                auto byDegree = [&](int a, int b) { return neighbors[a].size() < neighbors[b].size() || (neighbors[a].size() == neighbors[b].size() && a < b); };
+
+                std::vector<int> nodesByDegree(nbNodes);
+
+                std::iota(nodesByDegree.begin(), nodesByDegree.end(), 0);
+                std::sort(nodesByDegree.begin(), nodesByDegree.end(), byDegree);
+
+                for (int seed : nodesByDegree) {
+                    if (isVisited[seed])
+                        continue;
+                    int start = PseudoPeripheralNode(neighbors, seed, levels, byDegree);
+
+                    std::size_t head = order.size();
+
+                    isVisited[start] = true;
+
+                    order.push_back(start);
+
+                    std::vector<int> next;
+
+                    for (; head < order.size(); head++) {
+                        next.clear();
+
+                        for (int neighbor : neighbors[order[head]]) {
+                            if (isVisited[neighbor])
+                                continue;
+                            isVisited[neighbor] = true;
+
+                            next.push_back(neighbor);
+                        }
+
+                        std::sort(next.begin(), next.end(), byDegree);
+
+                        order.insert(order.end(), next.begin(), next.end());
+                    }
+                }
+
+                std::reverse(order.begin(), order.end());
+
+                return order;
+            }
+
+        private:
+
+            /**
+            * @brief Moves start to the least-degree node of its last search level while that reaches deeper.
+            */
+            template<typename Compare>
+            static int PseudoPeripheralNode(const std::vector<std::vector<int>> &neighbors, int start, std::vector<int> &levels, Compare byDegree)
+            {
+                auto [depth, lastLevel] = LastLevel(neighbors, start, levels);
+
+                while (true) {
+                    int candidate = *std::min_element(lastLevel.begin(), lastLevel.end(), byDegree);
+
+                    auto [candidateDepth, candidateLastLevel] = LastLevel(neighbors, candidate, levels);
+
+                    if (candidateDepth <= depth)
+                        return start;
+                    start     = candidate;
+                    depth     = candidateDepth;
+                    lastLevel = std::move(candidateLastLevel);
+                }
+            }
+
+            /**
+            * @brief Depth of the breadth-first search from start and the nodes of its last level, levels being left at -1.
+            */
+            static std::pair<int, std::vector<int>> LastLevel(const std::vector<std::vector<int>> &neighbors, int start, std::vector<int> &levels)
+            {
+                std::vector<int> visited = { start };
+
+                levels[start] = 0;
+
+                for (std::size_t head = 0; head < visited.size(); head++) {
+                    for (int neighbor : neighbors[visited[head]]) {
+                        if (levels[neighbor] >= 0)
+                            continue;
+                        levels[neighbor] = levels[visited[head]] + 1;
+
+                        visited.push_back(neighbor);
+                    }
+                }
+
+                int depth = levels[visited.back()];
+
+                std::vector<int> lastLevel;
+
+                for (int node : visited) {
+                    if (levels[node] == depth)
+                        lastLevel.push_back(node);
+                    levels[node] = -1;
+                }
+
+                return { depth, lastLevel };
+            }
+    };
+};
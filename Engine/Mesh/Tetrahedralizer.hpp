@@ -0,0 +1,488 @@
+#pragma once
+
+#include "Ordering.hpp"
+#include "Utils/Utils.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Delaunay tetrahedra filling a closed triangulation, from its vertices and a jittered interior grid.
+    */
+    class Tetrahedralizer {
+
+        public:
+
+            /**
+            * @brief Tetrahedra indexing the positions then the interior positions sampled, each positively oriented.
+            */
+            static std::vector<std::array<int, 4>> Tetrahedralize(const std::vector<glm::vec3> &positions, const std::vector<int> &triangles, int resolution, std::vector<glm::vec3> &interiorPositions)
+            {
+                Tetrahedralizer tetrahedralizer(positions, triangles);
+
+                interiorPositions = tetrahedralizer.SampleInterior(std::max(resolution, 1));
+
+                std::vector<glm::dvec3> points;
+
+                points.reserve(positions.size() + interiorPositions.size() + 4);
+
+                for (const auto& position : positions)
+                    points.push_back(glm::dvec3(position));
+                for (const auto& position : interiorPositions)
+                    points.push_back(glm::dvec3(position));
+                std::vector<std::array<int, 4>> tetrahedra;
+
+                for (const auto& tetrahedron : tetrahedralizer.Triangulate(points)) {
+                    const auto& v = tetrahedron.Vertices;
+
+                    glm::dvec3 centroid = 0.25 * (points[v[0]] + points[v[1]] + points[v[2]] + points[v[3]]);
+
+                    if (Quality(points[v[0]], points[v[1]], points[v[2]], points[v[3]]) < MIN_QUALITY || !tetrahedralizer.IsInside(centroid))
+                        continue;
+                    tetrahedra.push_back(v);
+                }
+
+                return tetrahedra;
+            }
+
+        private:
+
+            struct Tetrahedron {
+                std::array<int, 4> Vertices;
+                std::array<int, 4> Neighbors;  // Across the face opposite each vertex, -1 on the hull.
+                glm::dvec3         Center;
+                double             RadiusSquared;
+            };
+
+            Tetrahedralizer(const std::vector<glm::vec3> &positions, const std::vector<int> &triangles) : _Positions(positions), _Triangles(triangles)
+            {
+                _Lower = glm::dvec3(std::numeric_limits<double>::max());
+                _Upper = glm::dvec3(std::numeric_limits<double>::lowest());
+
+                for (int index : triangles) {
+                    _Lower = glm::min(_Lower, glm::dvec3(positions[index]));
+                    _Upper = glm::max(_Upper, glm::dvec3(positions[index]));
+                }
+
+                if (triangles.empty())
+                    _Lower = _Upper = glm::dvec3(0.0);
+                std::size_t nbTriangles = triangles.size() / 3;
+
+                glm::dvec3 extent = _Upper - _Lower;
+
+                _ColumnSize       = std::max(std::max(extent.x, extent.y) / std::max(std::sqrt((double)nbTriangles), 1.0), 1e-9);
+                _ColumnDimensions = glm::ivec2(glm::floor(glm::dvec2(extent) / _ColumnSize)) + 1;
+
+                _TrianglesPerColumn.resize((std::size_t)_ColumnDimensions.x * _ColumnDimensions.y);
+
+                for (std::size_t t = 0; t < nbTriangles; t++) {
+                    glm::dvec3 p0(positions[triangles[3 * t]]), p1(positions[triangles[3 * t + 1]]), p2(positions[triangles[3 * t + 2]]);
+
+                    glm::ivec2 first = ColumnOf(glm::min(glm::min(p0, p1), p2));
+                    glm::ivec2 last  = ColumnOf(glm::max(glm::max(p0, p1), p2));
+
+                    for (int x = first.x; x <= last.x; x++)
+                        for (int y = first.y; y <= last.y; y++)
+                            _TrianglesPerColumn[(std::size_t)y * _ColumnDimensions.x + x].push_back((int)t);
+                }
+            }
+
+            /**
+            * @brief Centers of the grid cells inside the surface and at least half a cell away from it.
+            */
+            std::vector<glm::vec3> SampleInterior(int resolution) const
+            {
+                glm::dvec3 extent   = _Upper - _Lower;
+                double     cellSize = std::max(std::max(extent.x, extent.y), extent.z) / resolution;
+
+                if (cellSize <= 0.0)
+                    return {};
+                glm::ivec3 dimensions = glm::max(glm::ivec3(glm::floor(extent / cellSize)), glm::ivec3(1));
+
+                auto cellIndex = [&](glm::ivec3 cell) {
+                    return ((std::size_t)cell.z * dimensions.y + cell.y) * dimensions.x + cell.x;
+                };
+
+                // The grid is centered on the bounds, the cells left over on each side being split evenly.
+                glm::dvec3 origin = _Lower + 0.5 * (extent - glm::dvec3(dimensions) * cellSize);
+
+                std::vector<bool> isNearSurface((std::size_t)dimensions.x * dimensions.y * dimensions.z, false);
+
+                for (std::size_t t = 0; t < _Triangles.size() / 3; t++) {
+                    glm::dvec3 p0(_Positions[_Triangles[3 * t]]), p1(_Positions[_Triangles[3 * t + 1]]), p2(_Positions[_Triangles[3 * t + 2]]);
+
+                    glm::ivec3 first = glm::clamp(glm::ivec3(glm::floor((glm::min(glm::min(p0, p1), p2) - origin) / cellSize - 0.5)), glm::ivec3(0), dimensions - 1);
+                    glm::ivec3 last  = glm::clamp(glm::ivec3(glm::floor((glm::max(glm::max(p0, p1), p2) - origin) / cellSize + 0.5)), glm::ivec3(0), dimensions - 1);
+
+                    for (int x = first.x; x <= last.x; x++) {
+                        for (int y = first.y; y <= last.y; y++) {
+                            for (int z = first.z; z <= last.z; z++) {
+                                glm::vec3 center = glm::vec3(origin + (glm::dvec3(x, y, z) + 0.5) * cellSize);
+
+                                if (glm::distance(center, Utils::ClosestPointOnTriangle(center, _Positions[_Triangles[3 * t]], _Positions[_Triangles[3 * t + 1]], _Positions[_Triangles[3 * t + 2]])) < 0.5 * cellSize)
+                                    isNearSurface[cellIndex({ x, y, z })] = true;
+                            }
+                        }
+                    }
+                }
+
+                std::vector<glm::vec3> interiorPositions;
+
+                for (int z = 0; z < dimensions.z; z++) {
+                    for (int y = 0; y < dimensions.y; y++) {
+                        for (int x = 0; x < dimensions.x; x++) {
+                            if (isNearSurface[cellIndex({ x, y, z })])
+                                continue;
+                            glm::dvec3 center = origin + (glm::dvec3(x, y, z) + 0.5) * cellSize + JITTER * cellSize * Jitter(cellIndex({ x, y, z }));
+
+                            if (IsInside(center))
+                                interiorPositions.push_back(glm::vec3(center));
+                        }
+                    }
+                }
+
+                return interiorPositions;
+            }
+
+            /**
+            * @brief Delaunay tetrahedra of the points, without the ones touching the enclosing tetrahedron.
+            */
+            std::vector<Tetrahedron> Triangulate(std::vector<glm::dvec3> &points)
+            {
+                std::size_t nbPoints = points.size();
+
+                glm::dvec3 center = 0.5 * (_Lower + _Upper);
+                double     size   = 100.0 * std::max(glm::length(_Upper - _Lower), 1e-6);
+
+                for (glm::dvec3 corner : { glm::dvec3(1, 1, 1), glm::dvec3(1, -1, -1), glm::dvec3(-1, 1, -1), glm::dvec3(-1, -1, 1) })
+                    points.push_back(center + size * corner);
+                _Tetrahedra.clear();
+                _FreeTetrahedra.clear();
+
+                AddTetrahedron(points, { (int)nbPoints, (int)nbPoints + 1, (int)nbPoints + 2, (int)nbPoints + 3 }, { -1, -1, -1, -1 });
+
+                int lastTetrahedron = 0;
+
+                for (int p : Ordering::Morton(points, nbPoints)) {
+                    int tetrahedron = Locate(points, points[p], lastTetrahedron);
+
+                    if (tetrahedron < 0)
+                        continue;  // A duplicate of a point already in.
+                    lastTetrahedron = Insert(points, p, tetrahedron);
+                }
+
+                std::vector<Tetrahedron> tetrahedra;
+
+                for (const auto& tetrahedron : _Tetrahedra) {
+                    if (tetrahedron.Vertices[0] < 0)
+                        continue;
+                    if (std::any_of(tetrahedron.Vertices.begin(), tetrahedron.Vertices.end(), [&](int v) { return v >= (int)nbPoints; }))
+                        continue;
+                    tetrahedra.push_back(tetrahedron);
+                }
+
+                points.resize(nbPoints);
+
+                return tetrahedra;
+            }
+
+            /**
+            * @brief The tetrahedron holding p, found by walking toward p from start, -1 when p is one of its vertices.
+            */
+            int Locate(const std::vector<glm::dvec3> &points, glm::dvec3 p, int start) const
+            {
+                int current = start;
+
+                for (std::size_t step = 0; step < _Tetrahedra.size(); step++) {
+                    const auto& tetrahedron = _Tetrahedra[current];
+
+                    int next = -1;
+
+                    for (int k = 0; k < 4 && next < 0; k++)
+                        if (tetrahedron.Neighbors[k] >= 0 && IsBeyond(points, Face(tetrahedron, k), tetrahedron.Vertices[k], p))
+                            next = tetrahedron.Neighbors[k];
+                    if (next < 0) {
+                        for (int v : tetrahedron.Vertices)
+                            if (points[v] == p)
+                                return -1;
+                        return current;
+                    }
+
+                    current = next;
+                }
+
+                // The walk cycled on nearly flat tetrahedra: any circumsphere holding p will do.
+                for (std::size_t t = 0; t < _Tetrahedra.size(); t++)
+                    if (_Tetrahedra[t].Vertices[0] >= 0 && IsInCircumsphere(_Tetrahedra[t], p))
+                        return (int)t;
+                return -1;
+            }
+
+            /**
+            * @brief Replaces the cavity of p around tetrahedron by the fan of its boundary to p, returning a new tetrahedron.
+            */
+            int Insert(const std::vector<glm::dvec3> &points, int p, int tetrahedron)
+            {
+                std::vector<int> cavity = { tetrahedron };
+
+                _IsInCavity.resize(_Tetrahedra.size(), false);
+                _IsInCavity[tetrahedron] = true;
+
+                for (std::size_t i = 0; i < cavity.size(); i++) {
+                    for (int neighbor : _Tetrahedra[cavity[i]].Neighbors) {
+                        if (neighbor < 0 || _IsInCavity[neighbor] || !IsInCircumsphere(_Tetrahedra[neighbor], points[p]))
+                            continue;
+                        _IsInCavity[neighbor] = true;
+
+                        cavity.push_back(neighbor);
+                    }
+                }
+
+                struct BoundaryFace {
+                    std::array<int, 3> Vertices;
+                    int                Inside;
+                    int                Outside;
+                };
+
+                std::vector<BoundaryFace> boundary;
+
+                for (bool isStarShaped = false; !isStarShaped;) {
+                    isStarShaped = true;
+                    boundary.clear();
+
+                    for (std::size_t i = 0; i < cavity.size() && isStarShaped; i++) {
+                        const auto& inside = _Tetrahedra[cavity[i]];
+
+                        for (int k = 0; k < 4; k++) {
+                            int outside = inside.Neighbors[k];
+
+                            if (outside >= 0 && _IsInCavity[outside])
+                                continue;
+                            std::array<int, 3> face = Face(inside, k);
+
+                            if (outside >= 0 && Orient(points[face[0]], points[face[1]], points[face[2]], points[p]) * Orient(points[face[0]], points[face[1]], points[face[2]], points[inside.Vertices[k]]) <= 0.0) {
+                                _IsInCavity[outside] = true;
+
+                                cavity.push_back(outside);
+
+                                isStarShaped = false;
+
+                                break;
+                            }
+
+                            boundary.push_back({ face, cavity[i], outside });
+                        }
+                    }
+                }
+
+                // p is the last vertex of each new tetrahedron.
+                std::vector<std::pair<std::array<int, 2>, std::array<int, 2>>> openFaces;
+
+                int newTetrahedron = -1;
+
+                for (const auto& face : boundary) {
+                    std::array<int, 4> vertices = { face.Vertices[0], face.Vertices[1], face.Vertices[2], p };
+
+                    if (Orient(points[vertices[0]], points[vertices[1]], points[vertices[2]], points[p]) < 0.0)
+                        std::swap(vertices[0], vertices[1]);
+                    newTetrahedron = AddTetrahedron(points, vertices, { -1, -1, -1, face.Outside });
+
+                    if (face.Outside >= 0)
+                        std::replace(_Tetrahedra[face.Outside].Neighbors.begin(), _Tetrahedra[face.Outside].Neighbors.end(), face.Inside, newTetrahedron);
+                    for (int k = 0; k < 3; k++) {
+                        std::array<int, 2> edge = { std::min(vertices[(k + 1) % 3], vertices[(k + 2) % 3]), std::max(vertices[(k + 1) % 3], vertices[(k + 2) % 3]) };
+
+                        auto match = std::find_if(openFaces.begin(), openFaces.end(), [&](const auto& openFace) { return openFace.first == edge; });
+
+                        if (match == openFaces.end()) {
+                            openFaces.push_back({ edge, { newTetrahedron, k } });
+
+                            continue;
+                        }
+
+                        _Tetrahedra[newTetrahedron].Neighbors[k]                     = match->second[0];
+                        _Tetrahedra[match->second[0]].Neighbors[match->second[1]] = newTetrahedron;
+
+                        *match = openFaces.back();
+
+                        openFaces.pop_back();
+                    }
+                }
+
+                // Freed last, as boundary faces still refer to them.
+                for (int t : cavity) {
+                    _IsInCavity[t]             = false;
+                    _Tetrahedra[t].Vertices[0] = -1;
+
+                    _FreeTetrahedra.push_back(t);
+                }
+
+                return newTetrahedron;
+            }
+
+            int AddTetrahedron(const std::vector<glm::dvec3> &points, const std::array<int, 4> &vertices, const std::array<int, 4> &neighbors)
+            {
+                glm::dvec3 a = points[vertices[0]];
+                glm::dvec3 b = points[vertices[1]] - a, c = points[vertices[2]] - a, d = points[vertices[3]] - a;
+
+                double denominator = 2.0 * glm::dot(b, glm::cross(c, d));
+
+                glm::dvec3 offset = (glm::dot(b, b) * glm::cross(c, d) + glm::dot(c, c) * glm::cross(d, b) + glm::dot(d, d) * glm::cross(b, c)) / denominator;
+
+                Tetrahedron tetrahedron = { vertices, neighbors, a + offset, denominator == 0.0 ? 0.0 : glm::dot(offset, offset) };
+
+                if (_FreeTetrahedra.empty()) {
+                    _Tetrahedra.push_back(tetrahedron);
+
+                    return (int)_Tetrahedra.size() - 1;
+                }
+
+                int t = _FreeTetrahedra.back();
+
+                _FreeTetrahedra.pop_back();
+
+                _Tetrahedra[t] = tetrahedron;
+
+                return t;
+            }
+
+            /**
+            * @brief Whether p is inside the surface, its winding number along the ray from p toward +z being non zero.
+            */
+            bool IsInside(glm::dvec3 p) const
+            {
+                if (glm::any(glm::lessThan(p, _Lower)) || glm::any(glm::greaterThan(p, _Upper)))
+                    return false;
+                glm::ivec2 column = ColumnOf(p);
+
+                int windingNumber = 0;
+
+                for (int t : _TrianglesPerColumn[(std::size_t)column.y * _ColumnDimensions.x + column.x]) {
+                    std::array<int, 3> v = { _Triangles[3 * t], _Triangles[3 * t + 1], _Triangles[3 * t + 2] };
+
+                    // Edges are evaluated from their lower vertex, so exactly one triangle holds a point on an edge.
+                    std::array<double, 3> weights;
+                    std::array<bool, 3>   isLeft;
+
+                    for (int k = 0; k < 3; k++) {
+                        int from = v[(k + 1) % 3], to = v[(k + 2) % 3];
+
+                        glm::dvec2 a(_Positions[std::min(from, to)]), b(_Positions[std::max(from, to)]);
+
+                        double side = (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+
+                        bool isLeftOfLowerToHigher = side != 0.0 ? side > 0.0 : b.y > a.y || (b.y == a.y && b.x < a.x);
+
+                        weights[k] = from < to ? side : -side;
+                        isLeft[k]  = from < to ? isLeftOfLowerToHigher : !isLeftOfLowerToHigher;
+                    }
+
+                    bool isPositive = isLeft[0] && isLeft[1] && isLeft[2];
+                    bool isNegative = !isLeft[0] && !isLeft[1] && !isLeft[2];
+
+                    if ((!isPositive && !isNegative) || weights[0] + weights[1] + weights[2] == 0.0)
+                        continue;
+                    double z = (weights[0] * _Positions[v[0]].z + weights[1] * _Positions[v[1]].z + weights[2] * _Positions[v[2]].z) / (weights[0] + weights[1] + weights[2]);
+
+                    if (z > p.z)
+                        windingNumber += isPositive ? 1 : -1;
+                }
+
+                return windingNumber != 0;
+            }
+
+            glm::ivec2 ColumnOf(glm::dvec3 p) const
+            {
+                return glm::clamp(glm::ivec2(glm::floor((glm::dvec2(p) - glm::dvec2(_Lower)) / _ColumnSize)), glm::ivec2(0), _ColumnDimensions - 1);
+            }
+
+            /**
+            * @brief Face opposite vertex k, in any order.
+            */
+            static std::array<int, 3> Face(const Tetrahedron &tetrahedron, int k)
+            {
+                return { tetrahedron.Vertices[(k + 1) % 4], tetrahedron.Vertices[(k + 2) % 4], tetrahedron.Vertices[(k + 3) % 4] };
+            }
+
+            /**
+            * @brief Whether p is strictly on the other side of the face than vertex.
+            */
+            static bool IsBeyond(const std::vector<glm::dvec3> &points, const std::array<int, 3> &face, int vertex, glm::dvec3 p)
+            {
+                double side = Orient(points[face[0]], points[face[1]], points[face[2]], p);
+
+                return side != 0.0 && (side > 0.0) != (Orient(points[face[0]], points[face[1]], points[face[2]], points[vertex]) > 0.0);
+            }
+
+            static bool IsInCircumsphere(const Tetrahedron &tetrahedron, glm::dvec3 p)
+            {
+                glm::dvec3 offset = p - tetrahedron.Center;
+
+                return glm::dot(offset, offset) < tetrahedron.RadiusSquared;
+            }
+
+            /**
+            * @brief Six times the signed volume of abcd, positive when d is on the side of abc its normal points to.
+            */
+            static double Orient(glm::dvec3 a, glm::dvec3 b, glm::dvec3 c, glm::dvec3 d)
+            {
+                return glm::dot(glm::cross(b - a, c - a), d - a);
+            }
+
+            /**
+            * @brief Volume over the cube of the root mean square edge length, normalized to 1 for a regular tetrahedron.
+            */
+            static double Quality(glm::dvec3 a, glm::dvec3 b, glm::dvec3 c, glm::dvec3 d)
+            {
+                double volume = Orient(a, b, c, d) / 6.0;
+                double meanEdgeLengthSquared = (glm::dot(b - a, b - a) + glm::dot(c - a, c - a) + glm::dot(d - a, d - a) + glm::dot(c - b, c - b) + glm::dot(d - b, d - b) + glm::dot(d - c, d - c)) / 6.0;
+
+                return meanEdgeLengthSquared > 0.0 ? 6.0 * std::sqrt(2.0) * volume / (meanEdgeLengthSquared * std::sqrt(meanEdgeLengthSquared)) : 0.0;
+            }
+
+            /**
+            * @brief Fixed pseudo-random offset in [-1, 1]^3 for cell, so that the same surface always gives the same tetrahedra.
+            */
+            static glm::dvec3 Jitter(std::size_t cell)
+            {
+                glm::dvec3 offset;
+
+                for (int k = 0; k < 3; k++) {
+                    std::uint64_t hash = (cell * 3 + k + 1) * 0x9E3779B97F4A7C15ull;
+
+                    hash = (hash ^ (hash >> 31)) * 0xBF58476D1CE4E5B9ull;
+                    hash ^= hash >> 29;
+
+                    offset[k] = (double)(hash >> 11) / (double)(1ull << 53) * 2.0 - 1.0;
+                }
+
+                return offset;
+            }
+
+        private:
+
+            static constexpr double MIN_QUALITY = 1e-3;
+            static constexpr double JITTER      = 1e-3;
+
+            const std::vector<glm::vec3> &_Positions;
+            const std::vector<int>       &_Triangles;
+
+            glm::dvec3 _Lower;
+            glm::dvec3 _Upper;
+
+            double                        _ColumnSize = 1.0;
+            glm::ivec2                    _ColumnDimensions {};
+            std::vector<std::vector<int>> _TrianglesPerColumn;
+
+            std::vector<Tetrahedron> _Tetrahedra;
+            std::vector<int>         _FreeTetrahedra;
+            std::vector<bool>        _IsInCavity;
+    };
+};
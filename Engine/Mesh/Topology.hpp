@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Corners around each vertex and half-edges along each edge of a triangle list, both in CSR.
+    */
+    class Topology {
+
+        public:
+
+            std::vector<int> CornerOffsets;
+            std::vector<int> Corners;
+
+            std::vector<std::array<int, 2>> Edges;  // Lower vertex, higher vertex.
+            std::vector<int>                EdgeOffsets;
+            std::vector<int>                HalfEdges;
+
+            std::vector<int> HalfEdgeEdges;  // Edge of each half-edge.
+            std::vector<int> Twins;          // -1 on the boundary and along the edges of more than two triangles.
+
+            Topology() = default;
+
+            Topology(const std::vector<int> &indices, std::size_t nbVertices)
+            {
+                int nbCorners = (int)(indices.size() / 3 * 3);
+
+                CornerOffsets = CountingSort(nbCorners, nbVertices, [&](int c) { return indices[c]; }, Corners);
+
+                // Bucketed by lower vertex, then sorted by higher vertex within each bucket.
+                auto lower  = [&](int h) { return std::min(indices[h], indices[Next(h)]); };
+                auto higher = [&](int h) { return std::max(indices[h], indices[Next(h)]); };
+
+                std::vector<int> lowerOffsets = CountingSort(nbCorners, nbVertices, lower, HalfEdges);
+
+                for (std::size_t v = 0; v < nbVertices; v++)
+                    std::sort(HalfEdges.begin() + lowerOffsets[v], HalfEdges.begin() + lowerOffsets[v + 1], [&](int a, int b) {
+                        return higher(a) != higher(b) ? higher(a) < higher(b) : a < b;
+                    });
+                HalfEdgeEdges.resize(nbCorners);
+                Twins.assign(nbCorners, -1);
+
+                for (int i = 0; i < nbCorners; i++) {
+                    int h = HalfEdges[i];
+
+                    if (Edges.empty() || Edges.back()[0] != lower(h) || Edges.back()[1] != higher(h)) {
+                        Edges.push_back({ lower(h), higher(h) });
+                        EdgeOffsets.push_back(i);
+                    }
+
+                    HalfEdgeEdges[h] = (int)Edges.size() - 1;
+                }
+
+                EdgeOffsets.push_back(nbCorners);
+
+                for (std::size_t e = 0; e < Edges.size(); e++) {
+                    if (NumberOfHalfEdges(e) != 2)
+                        continue;
+                    int first  = HalfEdges[EdgeOffsets[e]];
+                    int second = HalfEdges[EdgeOffsets[e] + 1];
+
+                    Twins[first]  = second;
+                    Twins[second] = first;
+                }
+            }
+
+            int NumberOfHalfEdges(std::size_t edge) const
+            {
+                return EdgeOffsets[edge + 1] - EdgeOffsets[edge];
+            }
+
+            /**
+            * @brief Whether every edge is shared by exactly two triangles.
+            */
+            bool IsClosed() const
+            {
+                for (std::size_t e = 0; e < Edges.size(); e++)
+                    if (NumberOfHalfEdges(e) != 2)
+                        return false;
+                return true;
+            }
+
+            /**
+            * @brief Next corner of the same triangle, also the end of the half-edge of corner.
+            */
+            static int Next(int corner)
+            {
+                return corner % 3 == 2 ? corner - 2 : corner + 1;
+            }
+
+            static int Previous(int corner)
+            {
+                return corner % 3 == 0 ? corner + 2 : corner - 1;
+            }
+
+        private:
+
+            /**
+            * @brief Stable counting sort of the corners by key into sorted, and the offsets of each key.
+            */
+            template<typename Key>
+            static std::vector<int> CountingSort(int nbCorners, std::size_t nbKeys, Key key, std::vector<int> &sorted)
+            {
+                std::vector<int> offsets(nbKeys + 1, 0);
+
+                for (int c = 0; c < nbCorners; c++)
+                    offsets[key(c) + 1]++;
+                for (std::size_t k = 0; k < nbKeys; k++)
+                    offsets[k + 1] += offsets[k];
+                std::vector<int> cursors(offsets.begin(), offsets.end() - 1);
+
+                sorted.resize(nbCorners);
+
+                for (int c = 0; c < nbCorners; c++)
+                    sorted[cursors[key(c)]++] = c;
+                return offsets;
+            }
+    };
+};
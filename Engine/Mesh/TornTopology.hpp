@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Triangles of a mesh before and after particles were split, for the constraints over them to follow the cut.
+    */
+    class TornTopology {
+
+        public:
+
+            TornTopology(const std::vector<int> &indices, const std::vector<std::vector<int>> &trianglesPerParticle, std::size_t nbParticles) : _Indices(indices), _TrianglesPerParticle(trianglesPerParticle), _Copies(nbParticles, -1), _IsNearSplit(nbParticles, false), _OriginalSlots(indices.size() / 3, -1) {};
+
+        public:
+
+            /**
+            * @brief Remembers the vertices of triangle t before it first moves.
+            */
+            void Move(int t)
+            {
+                if (_OriginalSlots[t] != -1)
+                    return;
+                _OriginalSlots[t] = (int)_OriginalTriangles.size();
+
+                _OriginalTriangles.push_back({ _Indices[3 * t], _Indices[3 * t + 1], _Indices[3 * t + 2] });
+            }
+
+            void Split(int particle, int copy)
+            {
+                _Copies[particle] = copy;
+
+                ForEachOriginalTriangle(particle, [&](int, const std::array<int, 3> &triangle) {
+                    for (int vertex : triangle)
+                        _IsNearSplit[vertex] = true;
+                });
+            }
+
+            /**
+            * @brief Whether particle shares a triangle with a split one, as it was before the splits.
+            */
+            bool IsNearSplit(int particle) const
+            {
+                return _IsNearSplit[particle];
+            }
+
+            bool IsSplit(int particle) const
+            {
+                return particle < (int)_Copies.size() && _Copies[particle] != -1;
+            }
+
+            template<std::size_t N>
+            bool IsTouched(const std::array<int, N> &particles) const
+            {
+                return std::any_of(particles.begin(), particles.end(), [this](int particle) { return IsSplit(particle); });
+            }
+
+            std::array<int, 3> OriginalTriangle(int t) const
+            {
+                return _OriginalSlots[t] != -1 ? _OriginalTriangles[_OriginalSlots[t]] : std::array<int, 3> { _Indices[3 * t], _Indices[3 * t + 1], _Indices[3 * t + 2] };
+            }
+
+            /**
+            * @brief Vertex standing for particle in triangle t since the splits.
+            */
+            int CurrentVertex(int t, int particle) const
+            {
+                auto triangle = OriginalTriangle(t);
+
+                for (int k = 0; k < 3; k++)
+                    if (triangle[k] == particle)
+                        return _Indices[3 * t + k];
+                return particle;
+            }
+
+            /**
+            * @brief Calls visit(t, vertices) on the triangles that used particle before the splits, with their vertices then.
+            */
+            template<typename Visitor>
+            void ForEachOriginalTriangle(int particle, Visitor visit) const
+            {
+                for (int t : _TrianglesPerParticle[particle])
+                    visit(t, OriginalTriangle(t));
+                if (IsSplit(particle))
+                    for (int t : _TrianglesPerParticle[_Copies[particle]])
+                        visit(t, OriginalTriangle(t));
+            }
+
+            int FindTriangle(int p, int q, int r) const
+            {
+                int found = -1;
+
+                ForEachOriginalTriangle(p, [&](int t, const std::array<int, 3> &triangle) {
+                    if (found == -1 && Contains(triangle, q) && Contains(triangle, r))
+                        found = t;
+                });
+
+                return found;
+            }
+
+            /**
+            * @brief Distinct pairs of vertices now standing for edge in the triangles along it, none when no triangle supports it.
+            */
+            std::vector<std::array<int, 2>> Edges(const std::array<int, 2> &edge) const
+            {
+                std::vector<std::array<int, 2>> edges;
+
+                ForEachOriginalTriangle(edge[0], [&](int t, const std::array<int, 3> &triangle) {
+                    if (!Contains(triangle, edge[1]))
+                        return;
+                    std::array<int, 2> current = { CurrentVertex(t, edge[0]), CurrentVertex(t, edge[1]) };
+
+                    if (std::find(edges.begin(), edges.end(), current) == edges.end())
+                        edges.push_back(current);
+                });
+
+                return edges;
+            }
+
+            /**
+            * @brief Follows the hinge (e0, e1) between the triangles (e0, e1, o1) and (e0, e1, o2), false if the cut went through it.
+            */
+            bool Hinge(std::array<int, 4> &hinge) const
+            {
+                int first  = FindTriangle(hinge[0], hinge[1], hinge[2]);
+                int second = FindTriangle(hinge[0], hinge[1], hinge[3]);
+
+                if (first == -1 || second == -1)
+                    return true;
+                std::array<int, 4> current = { CurrentVertex(first, hinge[0]), CurrentVertex(first, hinge[1]), CurrentVertex(first, hinge[2]), CurrentVertex(second, hinge[3]) };
+
+                if (current[0] != CurrentVertex(second, hinge[0]) || current[1] != CurrentVertex(second, hinge[1]))
+                    return false;
+                hinge = current;
+
+                return true;
+            }
+
+            /**
+            * @brief Same as Hinge for a bend known by its wings (o1, o2) only, as in the fast bend batch.
+            */
+            bool Wings(std::array<int, 2> &wings) const
+            {
+                std::array<int, 4> hinge = { -1, -1, wings[0], wings[1] };
+
+                ForEachOriginalTriangle(wings[0], [&](int, const std::array<int, 3> &first) {
+                    ForEachOriginalTriangle(wings[1], [&](int, const std::array<int, 3> &second) {
+                        std::array<int, 2> edge {};
+
+                        int nbShared = 0;
+
+                        for (int vertex : first)
+                            if (vertex != wings[0] && vertex != wings[1] && Contains(second, vertex) && nbShared < 2)
+                                edge[nbShared++] = vertex;
+                        if (nbShared == 2)
+                            hinge = { edge[0], edge[1], wings[0], wings[1] };
+                    });
+                });
+
+                if (hinge[0] == -1)
+                    return true;
+                if (!Hinge(hinge))
+                    return false;
+                wings = { hinge[2], hinge[3] };
+
+                return true;
+            }
+
+            void Triangle(std::array<int, 3> &triangle) const
+            {
+                int t = FindTriangle(triangle[0], triangle[1], triangle[2]);
+
+                if (t != -1)
+                    triangle = { CurrentVertex(t, triangle[0]), CurrentVertex(t, triangle[1]), CurrentVertex(t, triangle[2]) };
+            }
+
+            static bool Contains(const std::array<int, 3> &triangle, int particle)
+            {
+                return triangle[0] == particle || triangle[1] == particle || triangle[2] == particle;
+            }
+
+            /**
+            * @brief Triangles around each particle.
+            */
+            static std::vector<std::vector<int>> BuildTrianglesPerParticle(const std::vector<int> &indices, std::size_t nbParticles)
+            {
+                std::vector<std::vector<int>> trianglesPerParticle(nbParticles);
+
+                for (int t = 0; t < (int)indices.size() / 3; t++)
+                    for (int k = 0; k < 3; k++)
+                        trianglesPerParticle[indices[3 * t + k]].push_back(t);
+                return trianglesPerParticle;
+            }
+
+        private:
+
+            const std::vector<int>              &_Indices;
+            const std::vector<std::vector<int>> &_TrianglesPerParticle;
+
+            std::vector<int>  _Copies;
+            std::vector<bool> _IsNearSplit;
+
+            std::vector<int>                _OriginalSlots;
+            std::vector<std::array<int, 3>> _OriginalTriangles;
+    };
+};
@@ -1,9 +1,12 @@
 #pragma once
 
+#include "Topology.hpp"
+#include "Utils/ThreadPool.hpp"
 #include "Utils/Utils.hpp"
 
 #include <algorithm>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 namespace Exodia {
@@ -20,41 +23,79 @@ namespace Exodia {
         {
             if (Normals.empty())
                 Normals.resize(Positions.size());
-            for (int i = 0; i < Indices.size(); i += 3) {
-                int index1 = Indices[i    ];
-                int index2 = Indices[i + 1];
-                int index3 = Indices[i + 2];
+            const Topology& topology = GetTopology();
 
-                glm::vec3 v1 = { Positions[index1 * 3], Positions[index1 * 3 + 1], Positions[index1 * 3 + 2] };
-                glm::vec3 v2 = { Positions[index2 * 3], Positions[index2 * 3 + 1], Positions[index2 * 3 + 2] };
-                glm::vec3 v3 = { Positions[index3 * 3], Positions[index3 * 3 + 1], Positions[index3 * 3 + 2] };
+            std::vector<glm::vec3> triangleNormals(Indices.size() / 3);
 
-                glm::vec3 normal = glm::cross(v2 - v1, v3 - v1);
+            ThreadPool::Get().ParallelFor(triangleNormals.size(), NORMALS_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t t = begin; t < end; t++) {
+                    int index1 = Indices[3 * t    ];
+                    int index2 = Indices[3 * t + 1];
+                    int index3 = Indices[3 * t + 2];
 
-                Normals[index1 * 3    ] += normal.x;
-                Normals[index1 * 3 + 1] += normal.y;
-                Normals[index1 * 3 + 2] += normal.z;
+                    glm::vec3 v1 = { Positions[index1 * 3], Positions[index1 * 3 + 1], Positions[index1 * 3 + 2] };
+                    glm::vec3 v2 = { Positions[index2 * 3], Positions[index2 * 3 + 1], Positions[index2 * 3 + 2] };
+                    glm::vec3 v3 = { Positions[index3 * 3], Positions[index3 * 3 + 1], Positions[index3 * 3 + 2] };
 
-                Normals[index2 * 3    ] += normal.x;
-                Normals[index2 * 3 + 1] += normal.y;
-                Normals[index2 * 3 + 2] += normal.z;
+                    triangleNormals[t] = glm::cross(v2 - v1, v3 - v1);
+                }
+            });
 
-                Normals[index3 * 3    ] += normal.x;
-                Normals[index3 * 3 + 1] += normal.y;
-                Normals[index3 * 3 + 2] += normal.z;
-            }
+            ThreadPool::Get().ParallelFor(Positions.size() / 3, NORMALS_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t v = begin; v < end; v++) {
+                    glm::vec3 normal = { Normals[3 * v], Normals[3 * v + 1], Normals[3 * v + 2] };
+
+                    for (int c = topology.CornerOffsets[v]; c < topology.CornerOffsets[v + 1]; c++)
+                        normal += triangleNormals[topology.Corners[c] / 3];
+                    normal = glm::normalize(normal);
+
+                    Normals[3 * v    ] = normal.x;
+                    Normals[3 * v + 1] = normal.y;
+                    Normals[3 * v + 2] = normal.z;
+                }
+            });
+        }
+
+        /**
+        * @brief Adjacency of the triangles, built on first use; in-place index edits need an InvalidateTopology.
+        */
+        const Topology &GetTopology()
+        {
+            if (_Topology == nullptr || _Topology->CornerOffsets.size() != Positions.size() / 3 + 1 || _Topology->Corners.size() != Indices.size() / 3 * 3)
+                _Topology = std::make_shared<const Topology>(Indices, Positions.size() / 3);
+            return *_Topology;
+        }
+
+        void InvalidateTopology()
+        {
+            _Topology = nullptr;
+        }
+
+        /**
+        * @brief Appends a copy of the attributes of vertex index and returns the index of the copy, no triangle using it yet.
+        */
+        int DuplicateVertex(int index)
+        {
+            int copy = (int)(Positions.size() / 3);
 
-            for (int i = 0; i < Normals.size(); i += 3) {
-                glm::vec3 normal = { Normals[i], Normals[i + 1], Normals[i + 2] };
+            for (auto* values : { &Positions, &Normals, &UVs, &Colors }) {
+                if (values->empty() || values->size() % copy != 0)
+                    continue;
+                std::size_t nbChannels = values->size() / copy;
 
-                normal = glm::normalize(normal);
+                for (std::size_t k = 0; k < nbChannels; k++) {
+                    float value = (*values)[index * nbChannels + k];
 
-                Normals[i    ] = normal.x;
-                Normals[i + 1] = normal.y;
-                Normals[i + 2] = normal.z;
+                    values->push_back(value);
+                }
             }
+
+            return copy;
         }
 
+        /**
+        * @brief Coarser triangulation of the vertices, each dropped vertex folded onto its closest kept neighbor (-1 if none).
+        */
         void Subset(std::vector<int> &originalTriangleIndices, std::vector<int> &coarseVertexIndices, std::vector<int> &closestCoarseVertexIndices, std::vector<int> &prunedTriangleIndicesSubset)
         {
             unsigned long nbTotalVertices = Positions.size() / 3;
@@ -64,27 +105,26 @@ namespace Exodia {
 
             for (int index: originalTriangleIndices)
                 markedAsCoarse[index] = true;
-            std::vector<std::vector<int>> neighbors(nbTotalVertices, std::vector<int>());
+            Topology topology(originalTriangleIndices, nbTotalVertices);
 
-            for (unsigned int i = 0; i < originalTriangleIndices.size(); i += 3) {
-                int index0 = originalTriangleIndices[i    ];
-                int index1 = originalTriangleIndices[i + 1];
-                int index2 = originalTriangleIndices[i + 2];
+            std::vector<int> neighborOffsets(nbTotalVertices + 1);
+            std::vector<int> neighbors(2 * topology.Corners.size());
 
-                neighbors[index0].push_back(index1);
-                neighbors[index0].push_back(index2);
+            for (unsigned long i = 0; i <= nbTotalVertices; i++)
+                neighborOffsets[i] = 2 * topology.CornerOffsets[i];
+            for (std::size_t c = 0; c < topology.Corners.size(); c++) {
+                int corner = topology.Corners[c];
+                int first  = std::min(Topology::Next(corner), Topology::Previous(corner));
+                int second = std::max(Topology::Next(corner), Topology::Previous(corner));
 
-                neighbors[index1].push_back(index0);
-                neighbors[index1].push_back(index2);
-
-                neighbors[index2].push_back(index0);
-                neighbors[index2].push_back(index1);
+                neighbors[2 * c    ] = originalTriangleIndices[first];
+                neighbors[2 * c + 1] = originalTriangleIndices[second];
             }
             std::vector<unsigned int> nbCoarseNeighbors(nbTotalVertices, 0);
 
             for (unsigned int i = 0; i < nbTotalVertices; i++) {
-                for (auto neighbor: neighbors[i]) {
-                    if (markedAsCoarse[neighbor])
+                for (int n = neighborOffsets[i]; n < neighborOffsets[i + 1]; n++) {
+                    if (markedAsCoarse[neighbors[n]])
                         nbCoarseNeighbors[i] += 1;
                 }
             }
@@ -94,10 +134,10 @@ namespace Exodia {
                     continue;
                 bool fineNeighborsCondition = true;
 
-                for (auto neighbor: neighbors[i]) {
-                    if (markedAsCoarse[neighbor])
+                for (int n = neighborOffsets[i]; n < neighborOffsets[i + 1]; n++) {
+                    if (markedAsCoarse[neighbors[n]])
                         continue;
-                    if (nbCoarseNeighbors[neighbor] <= k) {
+                    if (nbCoarseNeighbors[neighbors[n]] <= k) {
                         fineNeighborsCondition = false;
 
                         break;
@@ -108,8 +148,8 @@ namespace Exodia {
                     continue;
                 markedAsCoarse[i] = false;
 
-                for (auto neighbor: neighbors[i])
-                    nbCoarseNeighbors[neighbor] -= 1;
+                for (int n = neighborOffsets[i]; n < neighborOffsets[i + 1]; n++)
+                    nbCoarseNeighbors[neighbors[n]] -= 1;
             }
 
             for (int i = 0; i < nbTotalVertices; i++) {
@@ -127,11 +167,13 @@ namespace Exodia {
                 float minDistance = 1e3;
                 int   closest     = -1;
 
-                glm::vec3 position = { Positions[i], Positions[i + 1], Positions[i + 2] };
+                glm::vec3 position = { Positions[3 * i], Positions[3 * i + 1], Positions[3 * i + 2] };
+
+                for (int n = neighborOffsets[i]; n < neighborOffsets[i + 1]; n++) {
+                    int neighbor = neighbors[n];
 
-                for (auto neighbor: neighbors[i]) {
                     if (markedAsCoarse[neighbor]) {
-                        glm::vec3 neighborPosition = { Positions[neighbor], Positions[neighbor + 1], Positions[neighbor + 2] };
+                        glm::vec3 neighborPosition = { Positions[3 * neighbor], Positions[3 * neighbor + 1], Positions[3 * neighbor + 2] };
 
                         float distance = glm::distance(position, neighborPosition);
 
@@ -144,14 +186,12 @@ namespace Exodia {
 
                 closestCoarseVertexIndices[i] = closest;
             }
-            std::vector<int> rawTriangleIndicesSubset;
+            prunedTriangleIndicesSubset.reserve(Indices.size());
 
-            for (int index: Indices)
-                rawTriangleIndicesSubset.push_back(closestCoarseVertexIndices[index]);
-            for (unsigned int i = 0; i < rawTriangleIndicesSubset.size(); i += 3) {
-                int index0 = rawTriangleIndicesSubset[i    ];
-                int index1 = rawTriangleIndicesSubset[i + 1];
-                int index2 = rawTriangleIndicesSubset[i + 2];
+            for (unsigned int i = 0; i + 2 < Indices.size(); i += 3) {
+                int index0 = closestCoarseVertexIndices[Indices[i    ]];
+                int index1 = closestCoarseVertexIndices[Indices[i + 1]];
+                int index2 = closestCoarseVertexIndices[Indices[i + 2]];
 
                 if (index0 == -1 || index1 == -1 || index2 == -1)
                     continue;
@@ -162,5 +202,11 @@ namespace Exodia {
                 prunedTriangleIndicesSubset.push_back(index2);
             }
         }
+
+        private:
+
+            static constexpr std::size_t NORMALS_GRAIN_SIZE = 4096;
+
+            std::shared_ptr<const Topology> _Topology;
     };
 };
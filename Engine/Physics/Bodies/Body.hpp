@@ -1,6 +1,12 @@
 #pragma once
 
 #include "Mesh/Mesh.hpp"
+#include "Mesh/TornTopology.hpp"
+#include "BodyTemplate.hpp"
+#include "CollisionProxy.hpp"
+#include "EmbeddedMesh.hpp"
+#include "ParticleHierarchy.hpp"
+#include "ParticleReordering.hpp"
 #include "Particle/Particle.hpp"
 #include "Constraints/Constraint.hpp"
 #include "Constraints/DistanceConstraint.hpp"
@@ -8,8 +14,26 @@
 #include "Constraints/CollisionConstraint.hpp"
 #include "Constraints/FastBendConstraint.hpp"
 #include "Constraints/VolumeConstraint.hpp"
+#include "Constraints/DeviatoricConstraint.hpp"
 #include "Constraints/DihedralBendConstraint.hpp"
+#include "Constraints/IsometricBendConstraint.hpp"
+#include "Constraints/TriangleStrainConstraint.hpp"
+#include "Constraints/TetherConstraint.hpp"
 #include "Constraints/GlobalVolumeConstraint.hpp"
+#include "Constraints/ShapeMatchingConstraint.hpp"
+#include "Constraints/AttachmentConstraint.hpp"
+#include "Constraints/ConstraintBatch.hpp"
+#include "Utils/Utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <utility>
 
 namespace Exodia {
 
@@ -17,134 +41,420 @@ namespace Exodia {
 
         public:
 
-            Body(std::shared_ptr<Mesh> mesh, float mass) : _Mesh(mesh), _Mass(mass)
+            /**
+            * @brief One particle per distinct position of the mesh, or a copy of a filled template (see BodyTemplate).
+            */
+            Body(std::shared_ptr<Mesh> mesh, float mass, std::shared_ptr<BodyTemplate> bodyTemplate = nullptr, std::vector<float> templateParameters = {}) : _Mesh(mesh), _Mass(mass)
             {
-                _Mesh->BakeRotationIntoGetVertex();
-                _Mesh->BakeScalingIntoGetVertex();
+                // Baking uploads the mesh, skipped when baked beforehand (see BodyPool).
+                if (_Mesh->Transform()->Rotation != glm::vec3(0.0f))
+                    _Mesh->BakeRotationIntoGetVertex();
+                if (_Mesh->Transform()->Scale != glm::vec3(1.0f))
+                    _Mesh->BakeScalingIntoGetVertex();
 
                 auto meshPosition = _Mesh->Transform()->Position;
 
-                unsigned int nbParticles = mesh->GetVertex().Positions.size() / 3;
+                std::vector<float> particlePositions;
+
+                if (bodyTemplate != nullptr) {
+                    templateParameters.push_back(mass);
+
+                    _SourceHash = BodyCache::Hash(mesh->GetVertex(), templateParameters);
+
+                    std::lock_guard<std::mutex> lock(bodyTemplate->Mutex);
+
+                    if (!bodyTemplate->IsFilled)
+                        bodyTemplate->Load(_SourceHash);
+                    const auto& vertex = mesh->GetVertex();
+
+                    _IsFromTemplate = bodyTemplate->Matches(_SourceHash) && 3 * bodyTemplate->VertexParticles.size() == vertex.Positions.size() && bodyTemplate->Triangles.size() == vertex.Indices.size();
+
+                    if (!bodyTemplate->IsFilled)
+                        _Template = bodyTemplate;
+                }
+
+                if (_IsFromTemplate) {
+                    particlePositions = bodyTemplate->RestPositions;
+                    _VertexParticles  = bodyTemplate->VertexParticles;
+                    _Triangles        = bodyTemplate->Triangles;
+                } else {
+                    _VertexParticles = Utils::WeldVertices(mesh->GetVertex().Positions, particlePositions, WELD_DISTANCE);
+
+                    _Triangles.reserve(mesh->GetVertex().Indices.size());
+
+                    for (int index : mesh->GetVertex().Indices)
+                        _Triangles.push_back(_VertexParticles[index]);
+                }
+                std::size_t nbParticles = particlePositions.size() / 3;
 
                 _Particles.reserve(nbParticles);
 
-                for (unsigned int i = 0; i < mesh->GetVertex().Positions.size(); i += 3) {
-                    glm::vec3 particlePosition = { mesh->GetVertex().Positions[i], mesh->GetVertex().Positions[i + 1], mesh->GetVertex().Positions[i + 2] };
+                for (std::size_t i = 0; i < nbParticles; i++) {
+                    glm::vec3 particlePosition = { particlePositions[3 * i], particlePositions[3 * i + 1], particlePositions[3 * i + 2] };
 
-                    _Particles.push_back(std::make_shared<Particle>(mass / (float)nbParticles, particlePosition + meshPosition, i));
+                    _Particles.push_back(std::make_shared<Particle>(mass / (float)nbParticles, particlePosition + meshPosition, 3 * i));
                 }
+                UpdateParticleNormals();
+
+                if (_IsFromTemplate)
+                    Instantiate(bodyTemplate);
             };
 
+            virtual ~Body() = default;
+
             void BuildParticleHierarchy(int nbLevels)
             {
-                std::vector<std::vector<int>> triangulations;
+                BuildParticleHierarchyAsync(nbLevels);
+                WaitForParticleHierarchy();
+            }
+
+            /**
+            * @brief Builds the particle hierarchy on its own thread, or loads it from the cache; see WaitForParticleHierarchy.
+            */
+            void BuildParticleHierarchyAsync(int nbLevels)
+            {
+                if (_TearingStrain > 0.0f)
+                    nbLevels = 1;  // See SetTearing.
+                WaitForParticleHierarchy();
 
-                triangulations.push_back(_Mesh->GetVertex().Indices);
+                if (std::exchange(_IsParticleHierarchyPrebuilt, false) && nbLevels == (int)_DistanceConstraintsPerLevel.size())
+                    return;
 
-                std::vector<std::vector<int>> particleIndicesPerLevel;
+                // Built in mesh order, which coarsens best, then renumbered.
+                std::size_t nbParticles = _Particles.size();
 
-                particleIndicesPerLevel.push_back(std::vector<int>());
+                std::vector<int>   newIndices;
+                std::vector<float> positions(3 * nbParticles);
+                std::vector<int>   triangles = _Triangles;
 
-                for (int i = 0; i < _Particles.size(); i++)
-                    particleIndicesPerLevel[0].push_back(i);
-                std::vector<std::vector<int>> closestCoarseVertexIndicesPerLevel;
+                if (!_MeshIndices.empty()) {
+                    newIndices.resize(nbParticles);
 
-                closestCoarseVertexIndicesPerLevel.push_back(std::vector<int>());
+                    for (std::size_t i = 0; i < nbParticles; i++)
+                        newIndices[MeshIndex(i)] = (int)i;
+                    for (int& index : triangles)
+                        index = MeshIndex(index);
+                }
+
+                for (std::size_t i = 0; i < nbParticles; i++)
+                    for (int k = 0; k < 3; k++)
+                        positions[3 * MeshIndex(i) + k] = _Particles[i]->InitialPosition[k];
+                _PendingParticleHierarchy = std::async(std::launch::async, [positions = std::move(positions), triangles = std::move(triangles), newIndices = std::move(newIndices), nbLevels, cachePath = _ParticleHierarchyCachePath]() {
+                    auto hierarchy = ParticleHierarchy::LoadOrBuild(positions, triangles, nbLevels, cachePath);
+
+                    if (!newIndices.empty())
+                        hierarchy.Renumber(newIndices);
+                    return hierarchy;
+                });
+            }
 
-                for (int i = 0; i < _Particles.size(); i++)
-                    closestCoarseVertexIndicesPerLevel[0].push_back(i);
+            /**
+            * @brief Blocks until the hierarchy started by BuildParticleHierarchyAsync is built, and sets up the levels from it.
+            */
+            void WaitForParticleHierarchy()
+            {
+                if (_PendingParticleHierarchy.valid())
+                    SetParticleHierarchy(_PendingParticleHierarchy.get());
+            }
 
-                for (unsigned int level = 1; level <= nbLevels; level++) {
-                    std::vector<int> coarseVertexIndices;
-                    std::vector<int> closestCoarseVertexIndices;
-                    std::vector<int> newTriangulation;
-                    std::vector<int> previousTriangulation = triangulations[triangulations.size() - 1];
+            /**
+            * @brief File caching the particle hierarchy across bodies and runs.
+            */
+            void SetParticleHierarchyCachePath(const std::string &path)
+            {
+                _ParticleHierarchyCachePath = path;
+            }
 
-                    _Mesh->GetVertex().Subset(previousTriangulation, coarseVertexIndices, closestCoarseVertexIndices, newTriangulation);
+            /**
+            * @brief Packs and colors the constraints, tethers and shape matching clusters that changed since the last call.
+            */
+            void PackConstraints()
+            {
+                WaitForParticleHierarchy();
 
-                    triangulations.push_back(newTriangulation);
-                    particleIndicesPerLevel.push_back(coarseVertexIndices);
-                    closestCoarseVertexIndicesPerLevel.push_back(closestCoarseVertexIndices);
+                if (_ConstraintBatchesDirty)
+                    PackBatches();
+                if (_TethersDirty) {
+                    BuildTethers();
+                    PackTethers();
                 }
 
-                for (unsigned int level = 0; level < nbLevels; level++) {
-                    if (level == 0) {
-                        _DistanceConstraintsPerLevel.emplace_back(_DistanceConstraints);
+                if (_ShapeMatchingDirty)
+                    BuildShapeMatchingClusters();
+            }
 
-                        continue;
-                    }
+            /**
+            * @brief Builds the hierarchy and packs the constraints ahead, off the solving thread (see BodyPool).
+            */
+            void Prepare()
+            {
+                BuildParticleHierarchy(DefaultParticleHierarchyLevels());
+                PackConstraints();
 
-                    _DistanceConstraintsPerLevel.emplace_back(_DistanceConstraintsPerLevel[level - 1]);
+                _IsParticleHierarchyPrebuilt = true;
+            }
 
-                    std::vector<std::shared_ptr<DistanceConstraint>> filteredConstraints{};
+            /**
+            * @brief Renumbers the particles, and whatever indexes them, in the given order; rigid bodies keep theirs.
+            */
+            void ReorderParticles(ParticleOrdering ordering)
+            {
+                if (ordering == ORDERING_NONE || ordering == _ParticleOrdering || IsRigid())
+                    return;
+                WaitForParticleHierarchy();
+                MaterializeConstraints();
 
-                    for (auto& constraint : _DistanceConstraintsPerLevel[level]) {
-                        bool shouldBeKept = true;
+                std::size_t nbParticles = _Particles.size();
 
-                        auto constraintCopy = std::make_shared<DistanceConstraint>(*constraint);
+                std::vector<int> order = ParticleReordering::Order(ordering, RestPositions(), _Triangles, _DistanceConstraints, _TriangleStrainConstraints, _FastBendConstraints, _DihedralBendConstraints, _IsometricBendConstraints, _VolumeConstraints, _DeviatoricConstraints);
+                std::vector<int> newIndices(nbParticles);
 
-                        for (auto& particle : constraintCopy->GetParticles()) {
-                            unsigned long particleIndex = particle->PositionIndex / 3;
+                std::vector<std::shared_ptr<Particle>> particles(nbParticles);
+                std::vector<glm::vec3>                 particleNormals(nbParticles);
 
-                            if (std::find(triangulations[level].begin(), triangulations[level].end(), particleIndex) != triangulations[level].end())
-                                continue;
-                            int closestParticleIndex = closestCoarseVertexIndicesPerLevel[level][particleIndex];
+                for (std::size_t i = 0; i < nbParticles; i++) {
+                    newIndices[order[i]] = (int)i;
+                    particles[i]         = _Particles[order[i]];
+                    particleNormals[i]   = _ParticleNormals[order[i]];
 
-                            if (closestParticleIndex == -1) {
-                                shouldBeKept = false;
+                    particles[i]->PositionIndex = 3 * i;
+                }
 
-                                continue;
-                            }
+                _Particles       = std::move(particles);
+                _ParticleNormals = std::move(particleNormals);
 
-                            constraintCopy->ReplaceParticle(particle, _Particles[closestParticleIndex]);
-                        }
+                auto remap = [&](auto &indices) {
+                    for (auto& index : indices)
+                        index = newIndices[index];
+                };
 
-                        if (constraintCopy->GetParticles()[0] == constraintCopy->GetParticles()[1])
-                            shouldBeKept = false;
-                        if (shouldBeKept)
-                            filteredConstraints.push_back(constraintCopy);
-                    }
+                remap(_Triangles);
+                remap(_VertexParticles);
+
+                _CollisionProxy.RemapParticles(newIndices);
+
+                if (!_ParticleHierarchy->TrianglesPerLevel.empty())
+                    EditParticleHierarchy().Renumber(newIndices);
+                std::vector<int> meshIndices(nbParticles);
+
+                for (std::size_t i = 0; i < nbParticles; i++)
+                    meshIndices[i] = MeshIndex(order[i]);
+                _MeshIndices = std::move(meshIndices);
+
+                for (const auto& attachment : _Attachments)
+                    attachment->RemapParticles(newIndices);
+                for (const auto& constraint : _GlobalVolumeConstraints)
+                    constraint->RemapParticles(_Particles, newIndices);
+                for (auto& constraints : _DistanceConstraintsPerLevel)
+                    ParticleReordering::SortByParticles(constraints);
+                ParticleReordering::SortByParticles(_DistanceConstraints);
+                ParticleReordering::SortByParticles(_TriangleStrainConstraints);
+                ParticleReordering::SortByParticles(_FastBendConstraints);
+                ParticleReordering::SortByParticles(_DihedralBendConstraints);
+                ParticleReordering::SortByParticles(_IsometricBendConstraints);
+                ParticleReordering::SortByParticles(_VolumeConstraints);
+                ParticleReordering::SortByParticles(_DeviatoricConstraints);
+
+                _TrianglesPerParticle.clear();
+
+                _ShapeMatchingDirty     = _ShapeMatchingDirty || _ShapeMatchingStiffness > 0.0f;
+                _ConstraintBatchesDirty = true;
+                _ParticleOrdering       = ordering;
+
+                PackTethers();
+            }
+
+            ParticleOrdering GetParticleOrdering() const
+            {
+                return _ParticleOrdering;
+            }
+
+        private:
+
+            /**
+            * @brief Index of particle in the order of the mesh, particles split by tears after a reordering keeping theirs.
+            */
+            int MeshIndex(std::size_t particle) const
+            {
+                return particle < _MeshIndices.size() ? _MeshIndices[particle] : (int)particle;
+            }
 
-                    _DistanceConstraintsPerLevel[level] = filteredConstraints;
+        public:
+
+            /**
+            * @brief Copies the predicted positions and inverse masses of the particles into the flat arrays used by the batches.
+            */
+            void GatherPredictedPositions()
+            {
+                _PredictedPositions.resize(_Particles.size());
+                _InverseMasses.resize(_Particles.size());
+
+                for (unsigned int i = 0; i < _Particles.size(); i++) {
+                    _PredictedPositions[i] = _Particles[i]->PredictedPosition;
+                    _InverseMasses[i]      = _Particles[i]->InverseMass;
                 }
+            }
 
-                _TrianglesPerLevel       = triangulations;
-                _ParticleIndicesPerLevel = particleIndicesPerLevel;
+            void ScatterPredictedPositions()
+            {
+                for (unsigned int i = 0; i < _Particles.size(); i++)
+                    _Particles[i]->PredictedPosition = _PredictedPositions[i];
             }
 
-            void UpdateVertex()
+            /**
+            * @brief Copies each particle to all of its vertices, then updates the normals and sends the mesh to the GPU.
+            */
+            virtual void UpdateVertex()
             {
-                for (const auto& particle : _Particles) {
-                    auto particleLocalPosition = particle->Position - Transform()->Position;
+                auto& positions = _Mesh->GetVertex().Positions;
 
-                    _Mesh->GetVertex().Positions[particle->PositionIndex    ] = particleLocalPosition.x;
-                    _Mesh->GetVertex().Positions[particle->PositionIndex + 1] = particleLocalPosition.y;
-                    _Mesh->GetVertex().Positions[particle->PositionIndex + 2] = particleLocalPosition.z;
+                for (std::size_t i = 0; i < _VertexParticles.size(); i++) {
+                    auto particleLocalPosition = _Particles[_VertexParticles[i]]->Position - Transform()->Position;
+
+                    positions[3 * i    ] = particleLocalPosition.x;
+                    positions[3 * i + 1] = particleLocalPosition.y;
+                    positions[3 * i + 2] = particleLocalPosition.z;
                 }
 
                 _Mesh->GetVertex().ComputeNormals();
 
-                _Mesh->SendVertexDataToGPU();
+                UpdateParticleNormals();
+
+                SendVertexToGPU();
             }
 
-            void Reset()
+            virtual void Reset()
             {
                 for (const auto& particle : _Particles)
                     particle->Reset();
+                _ShapeMatchingConstraint.ResetRotations();
+            }
+
+            /**
+            * @brief Moves the body at rest to position, keeping its constraints, cuts and hierarchy.
+            */
+            virtual void Respawn(glm::vec3 position)
+            {
+                glm::vec3 offset = position - Transform()->Position;
+
+                Transform()->Position = position;
+
+                for (const auto& particle : _Particles)
+                    particle->InitialPosition += offset;
+                for (auto& batch : _DistanceBatchesPerLevel)
+                    batch.ResetLambdas();
+                _TriangleStrainBatch.ResetLambdas();
+                _FastBendBatch.ResetLambdas();
+                _DihedralBendBatch.ResetLambdas();
+                _IsometricBendBatch.ResetLambdas();
+                _VolumeBatch.ResetLambdas();
+                _DeviatoricBatch.ResetLambdas();
+                _TetherBatch.ResetLambdas();
+
+                _IsParticleHierarchyPrebuilt = !_DistanceConstraintsPerLevel.empty();
+
+                Reset();
             }
 
         public:
 
+            /**
+            * @brief Whether the body moves as a whole (see RigidBody), its particles then only follow its pose.
+            */
+            virtual bool IsRigid() const
+            {
+                return false;
+            }
+
+            /**
+            * @brief Whether the body has no mass: none of its particles moves, so the solver leaves it out.
+            */
+            bool IsStatic() const
+            {
+                return _Mass == 0.0f;
+            }
+
+            /**
+            * @brief Whether the body was made from its template (see Body), its constraints then being already packed.
+            */
+            bool IsFromTemplate() const
+            {
+                return _IsFromTemplate;
+            }
+
+            /**
+            * @brief Levels of the hierarchy the solver builds for the body, coarse ones only for moving soft bodies.
+            */
+            int DefaultParticleHierarchyLevels() const
+            {
+                return _Mass > 0.0f && !IsRigid() ? 3 : 1;
+            }
+
             std::vector<std::shared_ptr<Particle>>& GetParticles()
             {
                 return _Particles;
             }
 
+            /**
+            * @brief Triangles of the mesh with each vertex replaced by its particle.
+            */
+            const std::vector<int>& GetTriangles() const
+            {
+                return _Triangles;
+            }
+
+            /**
+            * @brief Particle of each vertex of the mesh.
+            */
+            const std::vector<int>& GetVertexParticles() const
+            {
+                return _VertexParticles;
+            }
+
+            /**
+            * @brief Normal of each particle in mesh space, averaged from its vertices at the last UpdateVertex.
+            */
+            const std::vector<glm::vec3>& GetParticleNormals() const
+            {
+                return _ParticleNormals;
+            }
+
             std::shared_ptr<Mesh> GetMesh()
             {
                 return _Mesh;
             }
 
+            /**
+            * @brief Draws renderMesh, skinned to the body (see EmbeddedMesh), in place of the mesh; nullptr restores it.
+            */
+            void SetRenderMesh(std::shared_ptr<Mesh> renderMesh)
+            {
+                _Mesh->Visible = renderMesh == nullptr;
+
+                if (renderMesh == nullptr) {
+                    _RenderMesh = nullptr;
+
+                    return;
+                }
+
+                renderMesh->BakeRotationIntoGetVertex();
+                renderMesh->BakeScalingIntoGetVertex();
+                renderMesh->SetPickingEnabled(false);
+
+                std::vector<glm::vec3> restPositions(_Particles.size());
+
+                for (std::size_t i = 0; i < _Particles.size(); i++)
+                    restPositions[i] = _Particles[i]->InitialPosition;
+                _RenderMesh = std::make_unique<EmbeddedMesh>(renderMesh, restPositions, _Triangles);
+
+                UpdateVertex();
+            }
+
+            std::shared_ptr<Mesh> GetRenderMesh() const
+            {
+                return _RenderMesh == nullptr ? _Mesh : _RenderMesh->GetMesh();
+            }
+
             Transform *Transform()
             {
                 return _Mesh->Transform();
@@ -158,26 +468,256 @@ namespace Exodia {
             void AddFixedConstraint(std::shared_ptr<FixedConstraint> constraint)
             {
                 _FixedConstraints.push_back(constraint);
+
+                _TethersDirty = true;
+            }
+
+            /**
+            * @brief Ties every particle to its nearest pin (see BuildTethers), enabled by default.
+            */
+            void SetTethersEnabled(bool enabled)
+            {
+                _TethersEnabled = enabled;
+                _TethersDirty   = true;
+            }
+
+            bool AreTethersEnabled() const
+            {
+                return _TethersEnabled;
+            }
+
+            /**
+            * @brief Groups the particles into overlapping shape matching clusters of clusterRings edges, 0 stiffness disabling it.
+            */
+            void SetShapeMatching(float stiffness, unsigned int clusterRings = 2)
+            {
+                if (stiffness < 0.0f || stiffness > 1.0f)
+                    throw std::runtime_error("Invalid shape matching stiffness. Must be between 0 and 1.");
+                clusterRings = std::max(clusterRings, 1u);
+
+                if (clusterRings != _ShapeMatchingRings || (stiffness == 0.0f) != (_ShapeMatchingStiffness == 0.0f))
+                    _ShapeMatchingDirty = true;
+
+                _ShapeMatchingStiffness = stiffness;
+                _ShapeMatchingRings     = clusterRings;
+            }
+
+            /**
+            * @brief Attaches the particles within radius of center, compliance growing toward the rim; nullptr when there is none.
+            */
+            std::shared_ptr<AttachmentConstraint> Attach(glm::vec3 center, float radius, float compliance)
+            {
+                if (radius <= 0.0f || compliance < 0.0f)
+                    throw std::runtime_error("Invalid attachment. Radius must be positive and compliance must not be negative.");
+                std::vector<int>       indices;
+                std::vector<glm::vec3> offsets;
+                std::vector<float>     compliances;
+
+                for (int i = 0; i < (int)_Particles.size(); i++) {
+                    glm::vec3 offset = _Particles[i]->Position - center;
+
+                    float distance = glm::length(offset);
+
+                    if (distance > radius)
+                        continue;
+                    indices.push_back(i);
+                    offsets.push_back(offset);
+                    compliances.push_back(compliance / std::max(1.0f - distance / radius, 0.05f));
+                }
+
+                if (indices.empty())
+                    return nullptr;
+                auto attachment = std::make_shared<AttachmentConstraint>(indices, offsets, compliances, center);
+
+                AddAttachment(attachment);
+
+                return attachment;
+            }
+
+            void AddAttachment(std::shared_ptr<AttachmentConstraint> attachment)
+            {
+                _Attachments.push_back(attachment);
+            }
+
+            void RemoveAttachment(std::shared_ptr<AttachmentConstraint> attachment)
+            {
+                _Attachments.erase(std::remove(_Attachments.begin(), _Attachments.end(), attachment), _Attachments.end());
+            }
+
+            const std::vector<std::shared_ptr<AttachmentConstraint>>& GetAttachments() const
+            {
+                return _Attachments;
+            }
+
+            float GetShapeMatchingStiffness() const
+            {
+                return _ShapeMatchingStiffness;
+            }
+
+            unsigned int GetShapeMatchingRings() const
+            {
+                return _ShapeMatchingRings;
+            }
+
+            /**
+            * @brief Lets distance constraints break beyond maxStrain times their rest length, 0 disabling it.
+            */
+            void SetTearing(float maxStrain)
+            {
+                if (maxStrain < 0.0f)
+                    throw std::runtime_error("Invalid tearing strain. Must not be negative.");
+                if (maxStrain > 0.0f && !CanTear())
+                    throw std::runtime_error("This body can't tear.");
+                _TearingStrain = maxStrain;
+
+                if (maxStrain == 0.0f)
+                    return;
+                SetTethersEnabled(false);
+                WaitForParticleHierarchy();
+
+                if (_DistanceConstraintsPerLevel.size() <= 1)
+                    return;
+                _DistanceConstraintsPerLevel.resize(1);
+                EditParticleHierarchy().TrianglesPerLevel.resize(1);
+                EditParticleHierarchy().ParticleIndicesPerLevel.resize(1);
+
+                _CollisionLevel         = 0;
+                _ConstraintBatchesDirty = true;
+            }
+
+            float GetTearingStrain() const
+            {
+                return _TearingStrain;
+            }
+
+            /**
+            * @brief Whether SetTearing may enable tearing: only surfaces split along their triangles.
+            */
+            virtual bool CanTear() const
+            {
+                return !IsRigid();
+            }
+
+            /**
+            * @brief Splits the particles of the most stretched distance constraints, at most MAX_TEARS_PER_CALL.
+            */
+            void Tear()
+            {
+                if (_TearingStrain == 0.0f || _ConstraintBatchesDirty || _DistanceBatchesPerLevel.empty())
+                    return;
+                GatherPredictedPositions();
+
+                const auto& batch = _DistanceBatchesPerLevel[0];
+
+                std::vector<std::pair<float, std::array<int, 2>>> candidates;
+
+                for (std::size_t c = 0; c < batch.Size(); c++) {
+                    float restLength = batch.RestValues()[c];
+
+                    if (restLength < 1e-6f)
+                        continue;  // A zero-length constraint pins two particles together, it isn't a material.
+                    const auto& edge = batch.Indices()[c];
+
+                    glm::vec3 delta = _PredictedPositions[edge[0]] - _PredictedPositions[edge[1]];
+
+                    float maxLength = (1.0f + _TearingStrain) * restLength;
+
+                    if (glm::dot(delta, delta) > maxLength * maxLength)
+                        candidates.push_back({ 1.0f - glm::length(delta) / restLength, edge });
+                }
+
+                if (candidates.empty())
+                    return;
+                MaterializeConstraints();  // The split particles carry the constraint objects over with the batches.
+                std::sort(candidates.begin(), candidates.end());
+
+                if (_TrianglesPerParticle.size() != _Particles.size())
+                    _TrianglesPerParticle = TornTopology::BuildTrianglesPerParticle(_Triangles, _Particles.size());
+                TornTopology torn(_Triangles, _TrianglesPerParticle, _Particles.size());
+
+                unsigned int nbTears = 0;
+
+                for (const auto& [strain, edge] : candidates) {
+                    if (nbTears == MAX_TEARS_PER_CALL)
+                        break;
+                    if (torn.IsSplit(edge[0]) || torn.IsSplit(edge[1]))
+                        continue;
+                    glm::vec3 direction = _Particles[edge[1]]->Position - _Particles[edge[0]]->Position;
+
+                    if (SplitParticle(edge[0], direction, torn) || SplitParticle(edge[1], -direction, torn))
+                        nbTears++;
+                }
+
+                if (nbTears == 0)
+                    return;
+                _Mesh->GetVertex().InvalidateTopology();
+
+                PatchTornConstraints(torn);
+
+                _CollisionProxy.Invalidate();
             }
 
             void AddDistanceConstraint(std::shared_ptr<DistanceConstraint> constraint)
             {
+                MaterializeConstraints();
+
                 _DistanceConstraints.push_back(constraint);
+
+                _ConstraintBatchesDirty = true;
+            }
+
+            void AddTriangleStrainConstraint(std::shared_ptr<TriangleStrainConstraint> constraint)
+            {
+                MaterializeConstraints();
+
+                _TriangleStrainConstraints.push_back(constraint);
+
+                _ConstraintBatchesDirty = true;
             }
 
             void AddBendConstraint(std::shared_ptr<FastBendConstraint> constraint)
             {
+                MaterializeConstraints();
+
                 _FastBendConstraints.push_back(constraint);
+
+                _ConstraintBatchesDirty = true;
             }
 
             void AddDihedralBendConstraint(std::shared_ptr<DihedralBendConstraint> constraint)
             {
+                MaterializeConstraints();
+
                 _DihedralBendConstraints.push_back(constraint);
+
+                _ConstraintBatchesDirty = true;
+            }
+
+            void AddIsometricBendConstraint(std::shared_ptr<IsometricBendConstraint> constraint)
+            {
+                MaterializeConstraints();
+
+                _IsometricBendConstraints.push_back(constraint);
+
+                _ConstraintBatchesDirty = true;
             }
 
             void AddVolumeConstraint(std::shared_ptr<VolumeConstraint> constraint)
             {
+                MaterializeConstraints();
+
                 _VolumeConstraints.push_back(constraint);
+
+                _ConstraintBatchesDirty = true;
+            }
+
+            void AddDeviatoricConstraint(std::shared_ptr<DeviatoricConstraint> constraint)
+            {
+                MaterializeConstraints();
+
+                _DeviatoricConstraints.push_back(constraint);
+
+                _ConstraintBatchesDirty = true;
             }
 
             void AddGlobalVolumeConstraint(std::shared_ptr<GlobalVolumeConstraint> constraint)
@@ -192,6 +732,9 @@ namespace Exodia {
 
             std::vector<std::vector<std::shared_ptr<DistanceConstraint>>>& GetDistanceConstraintsPerLevel()
             {
+                WaitForParticleHierarchy();
+                MaterializeConstraints();
+
                 return _DistanceConstraintsPerLevel;
             }
 
@@ -202,24 +745,58 @@ namespace Exodia {
 
             std::vector<std::shared_ptr<DistanceConstraint>>& GetDistanceConstraints()
             {
+                MaterializeConstraints();
+
                 return _DistanceConstraints;
             }
 
+            std::vector<std::shared_ptr<TriangleStrainConstraint>>& GetTriangleStrainConstraints()
+            {
+                MaterializeConstraints();
+
+                return _TriangleStrainConstraints;
+            }
+
             std::vector<std::shared_ptr<FastBendConstraint>>& GetFastBendConstraints()
             {
+                MaterializeConstraints();
+
                 return _FastBendConstraints;
             }
 
             std::vector<std::shared_ptr<DihedralBendConstraint>>& GetDihedralBendConstraints()
             {
+                MaterializeConstraints();
+
                 return _DihedralBendConstraints;
             }
 
+            std::vector<std::shared_ptr<IsometricBendConstraint>>& GetIsometricBendConstraints()
+            {
+                MaterializeConstraints();
+
+                return _IsometricBendConstraints;
+            }
+
+            std::vector<std::shared_ptr<TetherConstraint>>& GetTetherConstraints()
+            {
+                return _TetherConstraints;
+            }
+
             std::vector<std::shared_ptr<VolumeConstraint>>& GetVolumeConstraints()
             {
+                MaterializeConstraints();
+
                 return _VolumeConstraints;
             }
 
+            std::vector<std::shared_ptr<DeviatoricConstraint>>& GetDeviatoricConstraints()
+            {
+                MaterializeConstraints();
+
+                return _DeviatoricConstraints;
+            }
+
             std::vector<std::shared_ptr<GlobalVolumeConstraint>>& GetGlobalVolumeConstraints()
             {
                 return _GlobalVolumeConstraints;
@@ -235,18 +812,24 @@ namespace Exodia {
                 return _Mass;
             }
 
-            std::vector<std::vector<GLint>>& GetTrianglesPerLevel()
+            const std::vector<std::vector<GLint>>& GetTrianglesPerLevel()
             {
-                return _TrianglesPerLevel;
+                WaitForParticleHierarchy();
+
+                return _ParticleHierarchy->TrianglesPerLevel;
             }
 
-            std::vector<std::vector<GLint>>& GetParticleIndicesPerLevel()
+            const std::vector<std::vector<GLint>>& GetParticleIndicesPerLevel()
             {
-                return _ParticleIndicesPerLevel;
+                WaitForParticleHierarchy();
+
+                return _ParticleHierarchy->ParticleIndicesPerLevel;
             }
 
             void SetCollisionLevel(int level)
             {
+                WaitForParticleHierarchy();
+
                 if (level < 0 || level >= _DistanceConstraintsPerLevel.size())
                     throw std::runtime_error("Invalid collision level. Must be between 0 and " + std::to_string(_DistanceConstraintsPerLevel.size() - 1) + ".");
                 _CollisionLevel = level;
@@ -257,28 +840,783 @@ namespace Exodia {
                 return _CollisionLevel;
             }
 
+            /**
+            * @brief Collides through a proxy of about nbTriangles triangles (see CollisionProxy), 0 using the collision level.
+            */
+            void SetCollisionProxy(std::size_t nbTriangles)
+            {
+                _CollisionProxy.Build(nbTriangles, RestPositions(), _Triangles);
+            }
+
+            /**
+            * @brief Swaps in the collision proxy rebuilt since the last call, and starts rebuilding it when tears invalidated it.
+            */
+            void UpdateCollisionProxy()
+            {
+                if (_CollisionProxy.Update())
+                    _CollisionProxy.RebuildAsync(RestPositions(), _Triangles);
+            }
+
+            /**
+            * @brief Triangles collided with, those of the collision proxy when there is one, else those of the collision level.
+            */
+            const std::vector<GLint>& GetCollisionTriangles()
+            {
+                return _CollisionProxy.IsEnabled() ? _CollisionProxy.GetTriangles() : GetTrianglesPerLevel()[_CollisionLevel];
+            }
+
+            /**
+            * @brief Particles colliding, the vertices of the collision proxy when there is one, else those of the collision level.
+            */
+            const std::vector<GLint>& GetCollisionParticles()
+            {
+                return _CollisionProxy.IsEnabled() ? _CollisionProxy.GetParticles() : GetParticleIndicesPerLevel()[_CollisionLevel];
+            }
+
+            std::vector<ConstraintBatch<DistanceKernel>>& GetDistanceBatchesPerLevel()
+            {
+                return _DistanceBatchesPerLevel;
+            }
+
+            ConstraintBatch<TriangleStrainKernel>& GetTriangleStrainBatch()
+            {
+                return _TriangleStrainBatch;
+            }
+
+            ConstraintBatch<DistanceKernel>& GetFastBendBatch()
+            {
+                return _FastBendBatch;
+            }
+
+            ConstraintBatch<DihedralBendKernel>& GetDihedralBendBatch()
+            {
+                return _DihedralBendBatch;
+            }
+
+            ConstraintBatch<IsometricBendKernel>& GetIsometricBendBatch()
+            {
+                return _IsometricBendBatch;
+            }
+
+            ConstraintBatch<VolumeKernel>& GetVolumeBatch()
+            {
+                return _VolumeBatch;
+            }
+
+            ConstraintBatch<DeviatoricKernel>& GetDeviatoricBatch()
+            {
+                return _DeviatoricBatch;
+            }
+
+            ConstraintBatch<TetherKernel>& GetTetherBatch()
+            {
+                return _TetherBatch;
+            }
+
+            ShapeMatchingConstraint& GetShapeMatchingConstraint()
+            {
+                return _ShapeMatchingConstraint;
+            }
+
+            std::vector<glm::vec3>& GetPredictedPositions()
+            {
+                return _PredictedPositions;
+            }
+
+            std::vector<float>& GetInverseMasses()
+            {
+                return _InverseMasses;
+            }
+
+        private:
+
+            /**
+            * @brief Packs and colors the constraints, then fills bodyTemplate when given one.
+            */
+            void PackBatches(BodyTemplate *bodyTemplate = nullptr)
+            {
+                MaterializeConstraints();
+
+                _DistanceBatchesPerLevel.assign(_DistanceConstraintsPerLevel.size(), {});
+
+                for (unsigned int level = 0; level < _DistanceConstraintsPerLevel.size(); level++)
+                    for (const auto& constraint : _DistanceConstraintsPerLevel[level])
+                        _DistanceBatchesPerLevel[level].Add(ParticleIndices<2>(*constraint), constraint->GetRestLength(), constraint->GetCompliance());
+                _TriangleStrainBatch.Clear();
+
+                for (const auto& constraint : _TriangleStrainConstraints)
+                    _TriangleStrainBatch.Add(ParticleIndices<3>(*constraint), constraint->GetRestValue(), constraint->GetCompliance());
+                _FastBendBatch.Clear();
+
+                for (const auto& constraint : _FastBendConstraints)
+                    _FastBendBatch.Add(ParticleIndices<2>(*constraint), constraint->GetRestLength(), constraint->GetCompliance());
+                _DihedralBendBatch.Clear();
+
+                for (const auto& constraint : _DihedralBendConstraints)
+                    _DihedralBendBatch.Add(ParticleIndices<4>(*constraint), constraint->GetRestAngle(), constraint->GetCompliance());
+                _IsometricBendBatch.Clear();
+
+                for (const auto& constraint : _IsometricBendConstraints)
+                    _IsometricBendBatch.Add(ParticleIndices<4>(*constraint), constraint->GetRestValue(), constraint->GetCompliance());
+                _VolumeBatch.Clear();
+
+                for (const auto& constraint : _VolumeConstraints)
+                    _VolumeBatch.Add(ParticleIndices<4>(*constraint), constraint->GetRestVolume(), constraint->GetCompliance());
+                _DeviatoricBatch.Clear();
+
+                for (const auto& constraint : _DeviatoricConstraints)
+                    _DeviatoricBatch.Add(ParticleIndices<4>(*constraint), constraint->GetRestValue(), constraint->GetCompliance());
+                for (auto& batch : _DistanceBatchesPerLevel)
+                    batch.Color(_Particles.size());
+                auto triangleStrainOrder = _TriangleStrainBatch.Color(_Particles.size());
+                auto fastBendOrder       = _FastBendBatch.Color(_Particles.size());
+
+                _DihedralBendBatch.Color(_Particles.size());
+                _IsometricBendBatch.Color(_Particles.size());
+                _VolumeBatch.Color(_Particles.size());
+                _DeviatoricBatch.Color(_Particles.size());
+
+                _ConstraintBatchesDirty = false;
+
+                if (bodyTemplate != nullptr)
+                    CopyToTemplate(*bodyTemplate, triangleStrainOrder, fastBendOrder);
+            }
+
+            void PackTethers()
+            {
+                _TetherBatch.Clear();
+
+                for (const auto& constraint : _TetherConstraints)
+                    _TetherBatch.Add(ParticleIndices<1>(*constraint), constraint->GetRestValue(), constraint->GetCompliance());
+                _TetherBatch.Color(_Particles.size());
+            }
+
+            /**
+            * @brief Gives each particle a tether to its geodesically closest pin.
+            */
+            void BuildTethers()
+            {
+                _TetherConstraints.clear();
+
+                _TethersDirty = false;
+
+                if (!_TethersEnabled || _FixedConstraints.empty())
+                    return;
+                std::size_t nbParticles = _Particles.size();
+
+                auto neighbors = BuildParticleNeighbors();
+
+                using Entry = std::pair<float, int>;
+
+                std::vector<float> distances(nbParticles, std::numeric_limits<float>::max());
+                std::vector<int>   closestPins(nbParticles, -1);
+
+                std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+
+                for (unsigned int pin = 0; pin < _FixedConstraints.size(); pin++) {
+                    int index = ParticleIndices<1>(*_FixedConstraints[pin])[0];
+
+                    if (distances[index] == 0.0f)
+                        continue;
+                    distances[index]   = 0.0f;
+                    closestPins[index] = pin;
+
+                    queue.push({ 0.0f, index });
+                }
+
+                while (!queue.empty()) {
+                    auto [distance, index] = queue.top();
+
+                    queue.pop();
+
+                    if (distance > distances[index])
+                        continue;
+                    for (const auto& [neighbor, length] : neighbors[index]) {
+                        float neighborDistance = distance + length;
+
+                        if (neighborDistance >= distances[neighbor])
+                            continue;
+                        distances[neighbor]   = neighborDistance;
+                        closestPins[neighbor] = closestPins[index];
+
+                        queue.push({ neighborDistance, neighbor });
+                    }
+                }
+
+                for (std::size_t i = 0; i < nbParticles; i++) {
+                    if (closestPins[i] == -1 || distances[i] == 0.0f)
+                        continue;
+                    glm::vec3 anchor = _FixedConstraints[closestPins[i]]->GetTargetPosition();
+
+                    _TetherConstraints.push_back(std::make_shared<TetherConstraint>(_Particles[i], anchor, distances[i], 0.0f));
+                }
+            }
+
+            /**
+            * @brief Replaces the shape matching clusters, grown ring by ring from their centers over the particle graph.
+            */
+            void BuildShapeMatchingClusters()
+            {
+                _ShapeMatchingConstraint.Clear();
+
+                _ShapeMatchingDirty = false;
+
+                if (_ShapeMatchingStiffness == 0.0f)
+                    return;
+                std::size_t nbParticles = _Particles.size();
+
+                auto neighbors = BuildParticleNeighbors();
+
+                std::vector<int>  depths(nbParticles, -1);
+                std::vector<bool> covered(nbParticles, false);
+
+                std::vector<int>       cluster;
+                std::vector<glm::vec3> restPositions;
+
+                for (std::size_t center = 0; center < nbParticles; center++) {
+                    if (covered[center])
+                        continue;
+                    cluster.assign(1, (int)center);
+
+                    depths[center] = 0;
+
+                    for (std::size_t head = 0; head < cluster.size(); head++) {
+                        int index = cluster[head];
+
+                        if (depths[index] == (int)_ShapeMatchingRings)
+                            continue;
+                        for (const auto& [neighbor, length] : neighbors[index]) {
+                            if (depths[neighbor] != -1)
+                                continue;
+                            depths[neighbor] = depths[index] + 1;
+
+                            cluster.push_back(neighbor);
+                        }
+                    }
+
+                    restPositions.clear();
+
+                    for (int index : cluster) {
+                        if (depths[index] < (int)_ShapeMatchingRings)
+                            covered[index] = true;
+                        depths[index] = -1;
+
+                        restPositions.push_back(_Particles[index]->InitialPosition);
+                    }
+
+                    _ShapeMatchingConstraint.AddCluster(cluster, restPositions);
+                }
+
+                _ShapeMatchingConstraint.Finalize(nbParticles);
+            }
+
+            /**
+            * @brief Neighbors of each particle with their rest distance, along edges and finest-level distance constraints.
+            */
+            std::vector<std::vector<std::pair<int, float>>> BuildParticleNeighbors() const
+            {
+                std::vector<std::vector<std::pair<int, float>>> neighbors(_Particles.size());
+
+                auto addEdge = [&](int a, int b, float length) {
+                    neighbors[a].push_back({ b, length });
+                    neighbors[b].push_back({ a, length });
+                };
+
+                const auto &indices = _Triangles;
+
+                for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+                    for (unsigned int k = 0; k < 3; k++) {
+                        int a = indices[i + k];
+                        int b = indices[i + (k + 1) % 3];
+
+                        addEdge(a, b, glm::distance(_Particles[a]->InitialPosition, _Particles[b]->InitialPosition));
+                    }
+                }
+
+                if (_DistanceBatchesPerLevel.empty())
+                    return neighbors;
+                const auto& batch = _DistanceBatchesPerLevel[0];
+
+                for (std::size_t c = 0; c < batch.Size(); c++)
+                    addEdge(batch.Indices()[c][0], batch.Indices()[c][1], batch.RestValues()[c]);
+                return neighbors;
+            }
+
+            /**
+            * @brief Takes the levels of the hierarchy, folding the distance constraints of each level onto the next.
+            */
+            void SetParticleHierarchy(ParticleHierarchy hierarchy)
+            {
+                MaterializeConstraints();
+
+                std::size_t nbLevels = hierarchy.TrianglesPerLevel.size() - 1;
+
+                std::vector<bool> isInLevel;
+
+                _DistanceConstraintsPerLevel.assign(1, _DistanceConstraints);
+
+                for (std::size_t level = 1; level < nbLevels; level++) {
+                    const auto& closestCoarseParticles = hierarchy.ClosestCoarseParticlesPerLevel[level];
+
+                    isInLevel.assign(_Particles.size(), false);
+
+                    for (int index : hierarchy.TrianglesPerLevel[level])
+                        isInLevel[index] = true;
+                    std::vector<std::shared_ptr<DistanceConstraint>> filteredConstraints {};
+
+                    for (const auto& constraint : _DistanceConstraintsPerLevel[level - 1]) {
+                        bool shouldBeKept = true;
+
+                        auto constraintCopy = std::make_shared<DistanceConstraint>(*constraint);
+
+                        for (auto& particle : constraintCopy->GetParticles()) {
+                            unsigned long particleIndex = particle->PositionIndex / 3;
+
+                            if (isInLevel[particleIndex])
+                                continue;
+                            int closestParticleIndex = closestCoarseParticles[particleIndex];
+
+                            if (closestParticleIndex == -1) {
+                                shouldBeKept = false;
+
+                                continue;
+                            }
+
+                            constraintCopy->ReplaceParticle(particle, _Particles[closestParticleIndex]);
+                        }
+
+                        if (constraintCopy->GetParticles()[0] == constraintCopy->GetParticles()[1])
+                            shouldBeKept = false;
+                        if (shouldBeKept)
+                            filteredConstraints.push_back(constraintCopy);
+                    }
+
+                    _DistanceConstraintsPerLevel.push_back(std::move(filteredConstraints));
+                }
+
+                hierarchy.ClosestCoarseParticlesPerLevel.clear();
+
+                _ParticleHierarchy = std::make_shared<ParticleHierarchy>(std::move(hierarchy));
+
+                _ConstraintBatchesDirty = true;
+            }
+
+            /**
+            * @brief Shares the constraint layouts and hierarchy of the template, the constraint objects being made lazily.
+            */
+            void Instantiate(std::shared_ptr<const BodyTemplate> bodyTemplate)
+            {
+                _DistanceBatchesPerLevel = bodyTemplate->DistanceBatchesPerLevel;
+                _TriangleStrainBatch     = bodyTemplate->TriangleStrainBatch;
+                _FastBendBatch           = bodyTemplate->FastBendBatch;
+                _DihedralBendBatch       = bodyTemplate->DihedralBendBatch;
+                _IsometricBendBatch      = bodyTemplate->IsometricBendBatch;
+                _VolumeBatch             = bodyTemplate->VolumeBatch;
+                _DeviatoricBatch         = bodyTemplate->DeviatoricBatch;
+                _ParticleHierarchy       = bodyTemplate->Hierarchy;
+
+                for (std::size_t i = 0; i < bodyTemplate->GlobalVolumes.size(); i++)
+                    AddGlobalVolumeConstraint(std::make_shared<GlobalVolumeConstraint>(_Particles, bodyTemplate->GlobalVolumeTriangles[i], bodyTemplate->GlobalVolumes[i][0], bodyTemplate->GlobalVolumes[i][1]));
+                _DistanceConstraintsPerLevel.assign(_DistanceBatchesPerLevel.size(), {});
+
+                _PendingConstraints          = std::move(bodyTemplate);
+                _ConstraintBatchesDirty      = false;
+                _IsParticleHierarchyPrebuilt = true;
+            }
+
+            void MaterializeConstraints()
+            {
+                auto bodyTemplate = std::exchange(_PendingConstraints, nullptr);
+
+                if (bodyTemplate == nullptr)
+                    return;
+                bodyTemplate->MakeConstraints(_Particles, _DistanceConstraintsPerLevel, _TriangleStrainConstraints, _FastBendConstraints, _DihedralBendConstraints, _IsometricBendConstraints, _VolumeConstraints, _DeviatoricConstraints);
+
+                if (!_DistanceConstraintsPerLevel.empty())
+                    _DistanceConstraints = _DistanceConstraintsPerLevel[0];
+            }
+
+            /**
+            * @brief Fills the template with the body as just packed, sharing its layouts and hierarchy (see BodyTemplate::Fill).
+            */
+            void CopyToTemplate(BodyTemplate &bodyTemplate, const std::vector<std::size_t> &triangleStrainOrder, const std::vector<std::size_t> &fastBendOrder) const
+            {
+                bodyTemplate.VertexParticles = _VertexParticles;
+                bodyTemplate.Triangles       = _Triangles;
+                bodyTemplate.Hierarchy       = _ParticleHierarchy;
+                bodyTemplate.SourceHash      = _SourceHash;
+
+                bodyTemplate.DistanceBatchesPerLevel = _DistanceBatchesPerLevel;
+                bodyTemplate.TriangleStrainBatch     = _TriangleStrainBatch;
+                bodyTemplate.FastBendBatch           = _FastBendBatch;
+                bodyTemplate.DihedralBendBatch       = _DihedralBendBatch;
+                bodyTemplate.IsometricBendBatch      = _IsometricBendBatch;
+                bodyTemplate.VolumeBatch             = _VolumeBatch;
+                bodyTemplate.DeviatoricBatch         = _DeviatoricBatch;
+
+                bodyTemplate.Fill(_Particles, _Mesh->Transform()->Position, _FastBendConstraints, fastBendOrder, _TriangleStrainConstraints, triangleStrainOrder, _GlobalVolumeConstraints);
+            }
+
+            /**
+            * @brief The hierarchy of this body alone, copied first when a template shares it.
+            */
+            ParticleHierarchy &EditParticleHierarchy()
+            {
+                if (_ParticleHierarchy.use_count() > 1)
+                    _ParticleHierarchy = std::make_shared<ParticleHierarchy>(*_ParticleHierarchy);
+                return *_ParticleHierarchy;
+            }
+
+            template<unsigned int N>
+            std::array<int, N> ParticleIndices(const Constraint &constraint) const
+            {
+                std::array<int, N> indices {};
+
+                for (unsigned int i = 0; i < N; i++)
+                    indices[i] = (int)(constraint.GetParticle(i)->PositionIndex / 3);
+                return indices;
+            }
+
+            std::vector<glm::vec3> RestPositions() const
+            {
+                std::vector<glm::vec3> restPositions(_Particles.size());
+
+                for (std::size_t i = 0; i < _Particles.size(); i++)
+                    restPositions[i] = _Particles[i]->InitialPosition;
+                return restPositions;
+            }
+
+            /**
+            * @brief Moves the triangles of particle ahead of it along direction to a copy of it, unless one side would be empty.
+            */
+            bool SplitParticle(int particle, glm::vec3 direction, TornTopology &torn)
+            {
+                auto& indices       = _Triangles;
+                auto& vertexIndices = _Mesh->GetVertex().Indices;
+
+                glm::vec3 origin = _Particles[particle]->Position;
+
+                std::vector<int> kept;
+                std::vector<int> moved;
+
+                for (int t : _TrianglesPerParticle[particle]) {
+                    glm::vec3 centroid = (_Particles[indices[3 * t]]->Position + _Particles[indices[3 * t + 1]]->Position + _Particles[indices[3 * t + 2]]->Position) / 3.0f;
+
+                    if (glm::dot(centroid - origin, direction) > 0.0f)
+                        moved.push_back(t);
+                    else
+                        kept.push_back(t);
+                }
+
+                if (kept.empty() || moved.empty())
+                    return false;
+                int copy = DuplicateParticle(particle);
+
+                std::vector<std::pair<int, int>> vertexCopies;
+
+                for (int t : moved) {
+                    torn.Move(t);
+
+                    for (int k = 0; k < 3; k++) {
+                        if (indices[3 * t + k] != particle)
+                            continue;
+                        indices[3 * t + k]               = copy;
+                        EditParticleHierarchy().TrianglesPerLevel[0][3 * t + k] = copy;
+
+                        int vertex = vertexIndices[3 * t + k];
+
+                        auto known = std::find_if(vertexCopies.begin(), vertexCopies.end(), [&](const auto &pair) { return pair.first == vertex; });
+
+                        if (known == vertexCopies.end()) {
+                            bool isKept = std::any_of(kept.begin(), kept.end(), [&](int u) {
+                                return vertexIndices[3 * u] == vertex || vertexIndices[3 * u + 1] == vertex || vertexIndices[3 * u + 2] == vertex;
+                            });
+
+                            vertexCopies.push_back({ vertex, isKept ? _Mesh->GetVertex().DuplicateVertex(vertex) : vertex });
+
+                            known = vertexCopies.end() - 1;
+
+                            if (isKept)
+                                _VertexParticles.push_back(copy);
+                            else
+                                _VertexParticles[vertex] = copy;
+                        }
+
+                        vertexIndices[3 * t + k] = known->second;
+                    }
+                }
+
+                _TrianglesPerParticle[particle] = std::move(kept);
+                _TrianglesPerParticle.push_back(std::move(moved));
+
+                torn.Split(particle, copy);
+
+                return true;
+            }
+
+            /**
+            * @brief Appends a copy of the particle, the two sharing its mass, and returns its index.
+            */
+            int DuplicateParticle(int particle)
+            {
+                int copy = (int)_Particles.size();
+
+                _Particles[particle]->Mass        *= 0.5f;
+                _Particles[particle]->InverseMass *= 2.0f;
+
+                auto duplicate = std::make_shared<Particle>(*_Particles[particle]);
+
+                duplicate->PositionIndex = 3 * copy;
+                duplicate->ExternalForces.clear();
+
+                _Particles.push_back(duplicate);
+                EditParticleHierarchy().ParticleIndicesPerLevel[0].push_back(copy);
+                _ParticleNormals.push_back(_ParticleNormals[particle]);
+
+                return copy;
+            }
+
+            /**
+            * @brief Carries the constraints of the split particles over to the triangles they now span, in place in the batches.
+            */
+            void PatchTornConstraints(const TornTopology &torn)
+            {
+                std::size_t nbDistanceConstraints = _DistanceConstraints.size();
+
+                for (std::size_t c = 0; c < nbDistanceConstraints; c++) {
+                    auto edge = ParticleIndices<2>(*_DistanceConstraints[c]);
+
+                    if (!torn.IsTouched(edge))
+                        continue;
+                    auto edges = torn.Edges(edge);
+
+                    for (std::size_t e = 0; e < edges.size(); e++) {
+                        auto constraint = _DistanceConstraints[c];
+
+                        if (e > 0) {
+                            constraint = std::make_shared<DistanceConstraint>(*_DistanceConstraints[c]);
+
+                            _DistanceConstraints.push_back(constraint);
+                        }
+
+                        constraint->SetParticles({ _Particles[edges[e][0]], _Particles[edges[e][1]] });
+                    }
+                }
+
+                _DistanceConstraintsPerLevel[0] = _DistanceConstraints;
+
+                auto& distanceBatch = _DistanceBatchesPerLevel[0];
+
+                std::vector<std::pair<std::array<int, 2>, std::size_t>> newEdges;
+
+                for (std::size_t c = 0; c < distanceBatch.Size(); c++) {
+                    if (!torn.IsTouched(distanceBatch.Indices()[c]))
+                        continue;
+                    auto edges = torn.Edges(distanceBatch.Indices()[c]);
+
+                    for (std::size_t e = 0; e < edges.size(); e++) {
+                        if (e == 0)
+                            distanceBatch.SetIndices(c, edges[e]);
+                        else
+                            newEdges.push_back({ edges[e], c });
+                    }
+                }
+
+                for (const auto& [edge, c] : newEdges)
+                    distanceBatch.AddColored(edge, distanceBatch.RestValues()[c], distanceBatch.Compliances()[c]);
+
+                auto followHinge = [&](std::array<int, 4> &hinge) {
+                    return !torn.IsTouched(hinge) || torn.Hinge(hinge);
+                };
+
+                auto patchBends = [&](auto &constraints, auto &batch) {
+                    std::erase_if(constraints, [&](const auto& constraint) {
+                        auto hinge = ParticleIndices<4>(*constraint);
+
+                        if (!torn.IsTouched(hinge))
+                            return false;
+                        if (!torn.Hinge(hinge))
+                            return true;
+                        constraint->SetParticles({ _Particles[hinge[0]], _Particles[hinge[1]], _Particles[hinge[2]], _Particles[hinge[3]] });
+
+                        return false;
+                    });
+
+                    batch.Remap(followHinge);
+                };
+
+                patchBends(_DihedralBendConstraints, _DihedralBendBatch);
+                patchBends(_IsometricBendConstraints, _IsometricBendBatch);
+
+                std::erase_if(_FastBendConstraints, [&](const auto& constraint) {
+                    auto wings = ParticleIndices<2>(*constraint);
+
+                    std::array<int, 4> hinge = { (int)(constraint->GetEdge()[0]->PositionIndex / 3), (int)(constraint->GetEdge()[1]->PositionIndex / 3), wings[0], wings[1] };
+
+                    if (!torn.IsTouched(hinge))
+                        return false;
+                    if (!torn.Hinge(hinge))
+                        return true;
+                    constraint->SetEdge({ _Particles[hinge[0]], _Particles[hinge[1]] });
+                    constraint->SetParticles({ _Particles[hinge[2]], _Particles[hinge[3]] });
+
+                    return false;
+                });
+
+                _FastBendBatch.Remap([&](std::array<int, 2> &wings) {
+                    return (!torn.IsNearSplit(wings[0]) && !torn.IsNearSplit(wings[1])) || torn.Wings(wings);
+                });
+
+                for (const auto& constraint : _TriangleStrainConstraints) {
+                    auto triangle = ParticleIndices<3>(*constraint);
+
+                    if (!torn.IsTouched(triangle))
+                        continue;
+                    torn.Triangle(triangle);
+
+                    constraint->SetParticles({ _Particles[triangle[0]], _Particles[triangle[1]], _Particles[triangle[2]] });
+                }
+
+                _TriangleStrainBatch.Remap([&](std::array<int, 3> &triangle) {
+                    if (torn.IsTouched(triangle))
+                        torn.Triangle(triangle);
+                    return true;
+                });
+
+                if (_TethersEnabled && !_FixedConstraints.empty()) {
+                    BuildTethers();
+                    PackTethers();
+                }
+
+                if (_ShapeMatchingStiffness > 0.0f)
+                    BuildShapeMatchingClusters();
+                _GlobalVolumeConstraints.clear();  // A torn surface encloses no volume.
+            }
+
+            static constexpr unsigned int MAX_TEARS_PER_CALL = 32;
+
+            static constexpr float WELD_DISTANCE = 0.001f;
+
+        protected:
+
+            void FillTemplate()
+            {
+                auto bodyTemplate = std::exchange(_Template, nullptr);
+
+                if (bodyTemplate == nullptr)
+                    return;
+                std::lock_guard<std::mutex> lock(bodyTemplate->Mutex);
+
+                if (bodyTemplate->IsFilled)
+                    return;  // Filled by a body built on another thread meanwhile: this one packs itself.
+                BuildParticleHierarchy(DefaultParticleHierarchyLevels());
+                PackBatches(bodyTemplate.get());
+
+                _IsParticleHierarchyPrebuilt = true;
+            }
+
+            /**
+            * @brief Sends the mesh to the GPU, or moves the render mesh drawn in its place.
+            */
+            void SendVertexToGPU()
+            {
+                if (_RenderMesh == nullptr)
+                    _Mesh->SendVertexDataToGPU();
+                else
+                    _RenderMesh->Skin(_Particles, _Triangles, _ParticleNormals, Transform()->Position);
+            }
+
+            /**
+            * @brief Averages the normals of the vertices of each particle.
+            */
+            void UpdateParticleNormals()
+            {
+                const auto& normals = _Mesh->GetVertex().Normals;
+
+                _ParticleNormals.assign(_Particles.size(), glm::vec3(0.0f));
+
+                if (normals.size() < 3 * _VertexParticles.size())
+                    return;
+                for (std::size_t v = 0; v < _VertexParticles.size(); v++)
+                    _ParticleNormals[_VertexParticles[v]] += glm::vec3(normals[3 * v], normals[3 * v + 1], normals[3 * v + 2]);
+                for (auto& normal : _ParticleNormals)
+                    if (glm::dot(normal, normal) > 0.0f)
+                        normal = glm::normalize(normal);
+            }
+
         protected:
 
             float _Mass;
 
             std::shared_ptr<Mesh> _Mesh;
+
+            std::unique_ptr<EmbeddedMesh> _RenderMesh;
             std::vector<std::shared_ptr<Particle>> _Particles;
 
+            std::vector<int>       _Triangles;
+            std::vector<int>       _VertexParticles;
+            std::vector<glm::vec3> _ParticleNormals;
+
         private:
 
             std::vector<std::vector<std::shared_ptr<DistanceConstraint>>> _DistanceConstraintsPerLevel;
 
-            std::vector<std::vector<int>> _TrianglesPerLevel;
-            std::vector<std::vector<int>> _ParticleIndicesPerLevel;
+            std::shared_ptr<ParticleHierarchy> _ParticleHierarchy = std::make_shared<ParticleHierarchy>();
+
+            std::future<ParticleHierarchy> _PendingParticleHierarchy;
+            std::string                    _ParticleHierarchyCachePath;
+
+            std::shared_ptr<BodyTemplate> _Template;
+            std::uint64_t                 _SourceHash                  = 0;
+            bool                          _IsFromTemplate              = false;
+            bool                          _IsParticleHierarchyPrebuilt = false;
+
+            std::shared_ptr<const BodyTemplate> _PendingConstraints;  // Template the constraint objects are still to be made from.
 
             int _CollisionLevel = 0;
 
-            std::vector<std::shared_ptr<FixedConstraint>>        _FixedConstraints;
-            std::vector<std::shared_ptr<DistanceConstraint>>     _DistanceConstraints;
-            std::vector<std::shared_ptr<FastBendConstraint>>     _FastBendConstraints;
-            std::vector<std::shared_ptr<DihedralBendConstraint>> _DihedralBendConstraints;
-            std::vector<std::shared_ptr<VolumeConstraint>>       _VolumeConstraints;
-            std::vector<std::shared_ptr<GlobalVolumeConstraint>> _GlobalVolumeConstraints;
-            std::vector<std::shared_ptr<CollisionConstraint>>    _CollisionConstraints;
+            CollisionProxy _CollisionProxy;
+
+            std::vector<std::shared_ptr<FixedConstraint>>          _FixedConstraints;
+            std::vector<std::shared_ptr<DistanceConstraint>>       _DistanceConstraints;
+            std::vector<std::shared_ptr<TriangleStrainConstraint>> _TriangleStrainConstraints;
+            std::vector<std::shared_ptr<FastBendConstraint>>       _FastBendConstraints;
+            std::vector<std::shared_ptr<DihedralBendConstraint>>   _DihedralBendConstraints;
+            std::vector<std::shared_ptr<IsometricBendConstraint>>  _IsometricBendConstraints;
+            std::vector<std::shared_ptr<VolumeConstraint>>         _VolumeConstraints;
+            std::vector<std::shared_ptr<DeviatoricConstraint>>     _DeviatoricConstraints;
+            std::vector<std::shared_ptr<GlobalVolumeConstraint>>   _GlobalVolumeConstraints;
+            std::vector<std::shared_ptr<TetherConstraint>>         _TetherConstraints;
+            std::vector<std::shared_ptr<CollisionConstraint>>      _CollisionConstraints;
+            std::vector<std::shared_ptr<AttachmentConstraint>>     _Attachments;
+
+            std::vector<ConstraintBatch<DistanceKernel>> _DistanceBatchesPerLevel;
+            ConstraintBatch<TriangleStrainKernel>        _TriangleStrainBatch;
+            ConstraintBatch<DistanceKernel>              _FastBendBatch;
+            ConstraintBatch<DihedralBendKernel>          _DihedralBendBatch;
+            ConstraintBatch<IsometricBendKernel>         _IsometricBendBatch;
+            ConstraintBatch<VolumeKernel>                _VolumeBatch;
+            ConstraintBatch<DeviatoricKernel>            _DeviatoricBatch;
+            ConstraintBatch<TetherKernel>                _TetherBatch;
+
+            ShapeMatchingConstraint _ShapeMatchingConstraint;
+
+            bool _ConstraintBatchesDirty = true;
+            bool _TethersEnabled         = true;
+            bool _TethersDirty           = false;
+
+            float        _ShapeMatchingStiffness = 0.0f;
+            unsigned int _ShapeMatchingRings     = 2;
+            bool         _ShapeMatchingDirty     = false;
+
+            float _TearingStrain = 0.0f;
+
+            ParticleOrdering _ParticleOrdering = ORDERING_NONE;
+            std::vector<int> _MeshIndices;
+
+            std::vector<std::vector<int>> _TrianglesPerParticle;
+
+            std::vector<glm::vec3> _PredictedPositions;
+            std::vector<float>     _InverseMasses;
     };
 };
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "Mesh/Vertex.hpp"
+#include "Constraints/ConstraintBatch.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Binary image of a BodyTemplate, 16-byte aligned so that every array is read in place.
+    */
+    class BodyCache {
+
+        public:
+
+            enum SectionId : std::uint32_t {
+                REST_POSITIONS,
+                VERTEX_PARTICLES,
+                TRIANGLES,
+                HIERARCHY_TRIANGLES,     // One section per level.
+                HIERARCHY_PARTICLES,     // One section per level.
+                FAST_BEND_EDGES,         // Shared edge of each fast bend constraint, in batch order.
+                STRAIN_WARP_DIRECTIONS,  // Warp direction of each strain constraint, in batch order.
+                GLOBAL_VOLUMES,          // Pressure and compliance of each global volume constraint.
+                GLOBAL_VOLUME_TRIANGLES, // One section per global volume constraint.
+
+                // A batch takes BATCH_FIELDS ids: indices, rest values, compliances and color offsets.
+                DISTANCE_BATCH         = 16, // One batch per level.
+                TRIANGLE_STRAIN_BATCH  = 20,
+                FAST_BEND_BATCH        = 24,
+                DIHEDRAL_BEND_BATCH    = 28,
+                ISOMETRIC_BEND_BATCH   = 32,
+                VOLUME_BATCH           = 36,
+                DEVIATORIC_BATCH       = 40
+            };
+
+            /**
+            * @brief FNV-1a of the positions, triangles and UVs of the mesh and of the construction parameters.
+            */
+            static std::uint64_t Hash(const Vertex &vertex, const std::vector<float> &parameters)
+            {
+                std::uint64_t hash = 14695981039346656037ull;
+
+                auto addBytes = [&](const void *data, std::size_t size) {
+                    for (std::size_t i = 0; i < size; i++)
+                        hash = (hash ^ ((const unsigned char *)data)[i]) * 1099511628211ull;
+                };
+
+                addBytes(vertex.Positions.data(), vertex.Positions.size() * sizeof(float));
+                addBytes(vertex.Indices.data(), vertex.Indices.size() * sizeof(int));
+                addBytes(vertex.UVs.data(), vertex.UVs.size() * sizeof(float));
+                addBytes(parameters.data(), parameters.size() * sizeof(float));
+
+                return hash;
+            }
+
+            template<typename T>
+            void Write(std::uint32_t id, std::uint32_t level, const std::vector<T> &values)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+
+                Section section { id, level, (std::uint32_t)sizeof(T), 0, _Data.size() * sizeof(Block), values.size() };
+
+                _Data.resize(_Data.size() + (values.size() * sizeof(T) + sizeof(Block) - 1) / sizeof(Block));
+
+                if (!values.empty())
+                    std::memcpy((std::byte *)_Data.data() + section.Offset, values.data(), values.size() * sizeof(T));
+                _Sections.push_back(section);
+            }
+
+            /**
+            * @brief Copies the section into values, false when it is missing or holds another type.
+            */
+            template<typename T>
+            bool Read(std::uint32_t id, std::uint32_t level, std::vector<T> &values) const
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+
+                const Section *section = Find(id, level);
+
+                if (section == nullptr || section->ElementSize != sizeof(T))
+                    return false;
+                values.resize(section->Count);
+
+                if (!values.empty())
+                    std::memcpy(values.data(), (const std::byte *)_Data.data() + section->Offset, values.size() * sizeof(T));
+                return true;
+            }
+
+            /**
+            * @brief Number of consecutive levels of the section, from level 0.
+            */
+            std::uint32_t NumberOfLevels(std::uint32_t id) const
+            {
+                std::uint32_t nbLevels = 0;
+
+                while (Find(id, nbLevels) != nullptr)
+                    nbLevels++;
+                return nbLevels;
+            }
+
+            template<typename Kernel>
+            void WriteBatch(std::uint32_t id, std::uint32_t level, const ConstraintBatch<Kernel> &batch)
+            {
+                Write(id    , level, batch.Indices());
+                Write(id + 1, level, batch.RestValues());
+                Write(id + 2, level, batch.Compliances());
+                Write(id + 3, level, batch.ColorOffsets());
+            }
+
+            /**
+            * @brief Reads a batch as it was packed and colored, its multipliers reset.
+            */
+            template<typename Kernel>
+            bool ReadBatch(std::uint32_t id, std::uint32_t level, ConstraintBatch<Kernel> &batch) const
+            {
+                typename ConstraintBatch<Kernel>::Layout layout;
+
+                if (!Read(id, level, layout.Indices) || !Read(id + 1, level, layout.RestValues) || !Read(id + 2, level, layout.Compliances) || !Read(id + 3, level, layout.ColorOffsets))
+                    return false;
+                std::size_t size = layout.Indices.size();
+
+                if (layout.RestValues.size() != size || layout.Compliances.size() != size || (!layout.ColorOffsets.empty() && layout.ColorOffsets.back() != size))
+                    return false;
+                batch.SetLayout(std::move(layout));
+
+                return true;
+            }
+
+            bool Load(const std::string &path, std::uint64_t sourceHash)
+            {
+                std::ifstream reader(path, std::ios::binary | std::ios::ate);
+
+                if (!reader.is_open())
+                    return false;
+                std::uint64_t fileSize = (std::uint64_t)reader.tellg();
+
+                if (fileSize < sizeof(Header) || fileSize % sizeof(Block) != 0)
+                    return false;
+                std::vector<Block> file(fileSize / sizeof(Block));
+
+                reader.seekg(0);
+                reader.read((char *)file.data(), fileSize);
+
+                if (!reader)
+                    return false;
+                Header header;
+
+                std::memcpy(&header, file.data(), sizeof(Header));
+
+                if (header.Magic != CACHE_MAGIC || header.Version != CACHE_VERSION || header.SourceHash != sourceHash)
+                    return false;
+                std::uint64_t dataOffset = sizeof(Header) + header.NbSections * sizeof(Section);
+
+                if (header.NbSections > MAX_SECTIONS || dataOffset > fileSize)
+                    return false;
+                _Sections.resize(header.NbSections);
+
+                std::memcpy(_Sections.data(), (const std::byte *)file.data() + sizeof(Header), header.NbSections * sizeof(Section));
+
+                for (auto& section : _Sections) {
+                    if (section.Offset % sizeof(Block) != 0 || section.ElementSize == 0 || section.Count > (fileSize - dataOffset) / section.ElementSize || section.Offset > fileSize - dataOffset - section.Count * section.ElementSize)
+                        return false;
+                }
+
+                _Data.assign(file.begin() + dataOffset / sizeof(Block), file.end());
+
+                return true;
+            }
+
+            void Save(const std::string &path, std::uint64_t sourceHash) const
+            {
+                std::ofstream writer(path, std::ios::binary);
+
+                if (!writer.is_open()) {
+                    std::cerr << "Could not write the body cache " << path << std::endl;
+
+                    return;
+                }
+
+                Header header {};
+
+                header.Magic      = CACHE_MAGIC;
+                header.Version    = CACHE_VERSION;
+                header.SourceHash = sourceHash;
+                header.NbSections = _Sections.size();
+
+                writer.write((const char *)&header, sizeof(header));
+                writer.write((const char *)_Sections.data(), _Sections.size() * sizeof(Section));
+                writer.write((const char *)_Data.data(), _Data.size() * sizeof(Block));
+            }
+
+        private:
+
+            struct alignas(16) Block {
+                std::byte Bytes[16];
+            };
+
+            struct Header {
+                std::uint32_t Magic;
+                std::uint32_t Version;
+                std::uint64_t SourceHash;
+                std::uint64_t NbSections;
+                std::uint64_t Padding;
+            };
+
+            /**
+            * @brief Offset is in bytes from the end of the section table.
+            */
+            struct Section {
+                std::uint32_t Id;
+                std::uint32_t Level;
+                std::uint32_t ElementSize;
+                std::uint32_t Padding;
+                std::uint64_t Offset;
+                std::uint64_t Count;
+            };
+
+            static_assert(sizeof(Header) % sizeof(Block) == 0 && sizeof(Section) % sizeof(Block) == 0);
+
+            const Section *Find(std::uint32_t id, std::uint32_t level) const
+            {
+                for (const auto& section : _Sections)
+                    if (section.Id == id && section.Level == level)
+                        return &section;
+                return nullptr;
+            }
+
+        public:
+
+            static constexpr std::uint32_t BATCH_FIELDS = 4;
+
+            static constexpr std::uint32_t CACHE_MAGIC   = 0x59425845; // "EXBY"
+            static constexpr std::uint32_t CACHE_VERSION = 2;
+            static constexpr std::uint64_t MAX_SECTIONS  = 4096;
+
+        private:
+
+            std::vector<Section> _Sections;
+            std::vector<Block>   _Data;
+    };
+};
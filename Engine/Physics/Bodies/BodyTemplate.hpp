@@ -0,0 +1,244 @@
+#pragma once
+
+#include "BodyCache.hpp"
+#include "ParticleHierarchy.hpp"
+#include "Particle/Particle.hpp"
+#include "Constraints/DistanceConstraint.hpp"
+#include "Constraints/FastBendConstraint.hpp"
+#include "Constraints/DihedralBendConstraint.hpp"
+#include "Constraints/IsometricBendConstraint.hpp"
+#include "Constraints/TriangleStrainConstraint.hpp"
+#include "Constraints/VolumeConstraint.hpp"
+#include "Constraints/DeviatoricConstraint.hpp"
+#include "Constraints/GlobalVolumeConstraint.hpp"
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Particles, packed constraints and hierarchy shared by the bodies built from the same mesh and parameters.
+    */
+    struct BodyTemplate {
+
+        BodyTemplate(const std::string &cachePath = "") : CachePath(cachePath) {};
+
+        std::string   CachePath;
+        std::uint64_t SourceHash = 0;
+        bool          IsFilled   = false;
+
+        std::mutex Mutex;
+
+        std::vector<float> RestPositions;  // In mesh space, x, y, z per particle.
+        std::vector<int>   VertexParticles;
+        std::vector<int>   Triangles;
+
+        std::shared_ptr<ParticleHierarchy> Hierarchy;
+
+        std::vector<ConstraintBatch<DistanceKernel>> DistanceBatchesPerLevel;
+        ConstraintBatch<TriangleStrainKernel>        TriangleStrainBatch;
+        ConstraintBatch<DistanceKernel>              FastBendBatch;
+        ConstraintBatch<DihedralBendKernel>          DihedralBendBatch;
+        ConstraintBatch<IsometricBendKernel>         IsometricBendBatch;
+        ConstraintBatch<VolumeKernel>                VolumeBatch;
+        ConstraintBatch<DeviatoricKernel>            DeviatoricBatch;
+
+        // What the batches lack to make the constraint objects back, in batch order.
+        std::shared_ptr<const std::vector<std::array<int, 2>>> FastBendEdges;
+        std::shared_ptr<const std::vector<glm::vec3>>          WarpDirections;
+
+        std::vector<std::array<float, 2>> GlobalVolumes;  // Pressure and compliance.
+        std::vector<std::vector<int>>     GlobalVolumeTriangles;
+
+        bool Matches(std::uint64_t sourceHash) const
+        {
+            return IsFilled && SourceHash == sourceHash;
+        }
+
+        /**
+        * @brief Stores the rest positions and what the batches lack once a body filled the template, then saves it.
+        */
+        void Fill(const std::vector<std::shared_ptr<Particle>> &particles, glm::vec3 meshPosition, const std::vector<std::shared_ptr<FastBendConstraint>> &fastBendConstraints, const std::vector<std::size_t> &fastBendOrder, const std::vector<std::shared_ptr<TriangleStrainConstraint>> &triangleStrainConstraints, const std::vector<std::size_t> &triangleStrainOrder, const std::vector<std::shared_ptr<GlobalVolumeConstraint>> &globalVolumeConstraints)
+        {
+            RestPositions.clear();
+            RestPositions.reserve(3 * particles.size());
+
+            for (const auto& particle : particles) {
+                glm::vec3 restPosition = particle->InitialPosition - meshPosition;
+
+                RestPositions.insert(RestPositions.end(), { restPosition.x, restPosition.y, restPosition.z });
+            }
+
+            auto fastBendEdges  = std::make_shared<std::vector<std::array<int, 2>>>();
+            auto warpDirections = std::make_shared<std::vector<glm::vec3>>();
+
+            for (std::size_t c : fastBendOrder) {
+                const auto& edge = fastBendConstraints[c]->GetEdge();
+
+                fastBendEdges->push_back({ (int)(edge[0]->PositionIndex / 3), (int)(edge[1]->PositionIndex / 3) });
+            }
+
+            for (std::size_t c : triangleStrainOrder)
+                warpDirections->push_back(triangleStrainConstraints[c]->GetWarpDirection());
+            FastBendEdges  = std::move(fastBendEdges);
+            WarpDirections = std::move(warpDirections);
+
+            GlobalVolumes.clear();
+            GlobalVolumeTriangles.clear();
+
+            for (const auto& constraint : globalVolumeConstraints) {
+                GlobalVolumes.push_back({ constraint->GetPressure(), constraint->GetCompliance() });
+                GlobalVolumeTriangles.push_back(constraint->GetIndices());
+            }
+
+            IsFilled = true;
+
+            Save();
+        }
+
+        /**
+        * @brief Makes the constraint objects of a body back from the batches.
+        */
+        void MakeConstraints(const std::vector<std::shared_ptr<Particle>> &particles, std::vector<std::vector<std::shared_ptr<DistanceConstraint>>> &distanceConstraintsPerLevel, std::vector<std::shared_ptr<TriangleStrainConstraint>> &triangleStrainConstraints, std::vector<std::shared_ptr<FastBendConstraint>> &fastBendConstraints, std::vector<std::shared_ptr<DihedralBendConstraint>> &dihedralBendConstraints, std::vector<std::shared_ptr<IsometricBendConstraint>> &isometricBendConstraints, std::vector<std::shared_ptr<VolumeConstraint>> &volumeConstraints, std::vector<std::shared_ptr<DeviatoricConstraint>> &deviatoricConstraints) const
+        {
+            for (std::size_t level = 0; level < distanceConstraintsPerLevel.size(); level++) {
+                const auto& batch = DistanceBatchesPerLevel[level];
+
+                for (std::size_t c = 0; c < batch.Size(); c++)
+                    distanceConstraintsPerLevel[level].push_back(std::make_shared<DistanceConstraint>(particles[batch.Indices()[c][0]], particles[batch.Indices()[c][1]], batch.Compliances()[c], batch.RestValues()[c]));
+            }
+
+            for (std::size_t c = 0; c < TriangleStrainBatch.Size(); c++) {
+                const auto& triangle = TriangleStrainBatch.Indices()[c];
+
+                triangleStrainConstraints.push_back(std::make_shared<TriangleStrainConstraint>(particles[triangle[0]], particles[triangle[1]], particles[triangle[2]], TriangleStrainBatch.Compliances()[c], TriangleStrainBatch.RestValues()[c], (*WarpDirections)[c]));
+            }
+
+            for (std::size_t c = 0; c < FastBendBatch.Size(); c++) {
+                const auto& edge  = (*FastBendEdges)[c];
+                const auto& wings = FastBendBatch.Indices()[c];
+
+                fastBendConstraints.push_back(std::make_shared<FastBendConstraint>(particles[edge[0]], particles[edge[1]], particles[wings[0]], particles[wings[1]], FastBendBatch.Compliances()[c], FastBendBatch.RestValues()[c]));
+            }
+
+            for (std::size_t c = 0; c < DihedralBendBatch.Size(); c++) {
+                const auto& hinge = DihedralBendBatch.Indices()[c];
+
+                dihedralBendConstraints.push_back(std::make_shared<DihedralBendConstraint>(particles[hinge[0]], particles[hinge[1]], particles[hinge[2]], particles[hinge[3]], DihedralBendBatch.Compliances()[c], DihedralBendBatch.RestValues()[c]));
+            }
+
+            for (std::size_t c = 0; c < IsometricBendBatch.Size(); c++) {
+                const auto& hinge = IsometricBendBatch.Indices()[c];
+
+                isometricBendConstraints.push_back(std::make_shared<IsometricBendConstraint>(particles[hinge[0]], particles[hinge[1]], particles[hinge[2]], particles[hinge[3]], IsometricBendBatch.Compliances()[c], IsometricBendBatch.RestValues()[c]));
+            }
+
+            for (std::size_t c = 0; c < VolumeBatch.Size(); c++) {
+                const auto& tetrahedron = VolumeBatch.Indices()[c];
+
+                volumeConstraints.push_back(std::make_shared<VolumeConstraint>(particles[tetrahedron[0]], particles[tetrahedron[1]], particles[tetrahedron[2]], particles[tetrahedron[3]], VolumeBatch.RestValues()[c], VolumeBatch.Compliances()[c]));
+            }
+
+            for (std::size_t c = 0; c < DeviatoricBatch.Size(); c++) {
+                const auto& tetrahedron = DeviatoricBatch.Indices()[c];
+
+                deviatoricConstraints.push_back(std::make_shared<DeviatoricConstraint>(particles[tetrahedron[0]], particles[tetrahedron[1]], particles[tetrahedron[2]], particles[tetrahedron[3]], DeviatoricBatch.Compliances()[c], DeviatoricBatch.RestValues()[c]));
+            }
+        }
+
+        /**
+        * @brief Fills the template from its cache file, false when there is none for sourceHash.
+        */
+        bool Load(std::uint64_t sourceHash)
+        {
+            BodyCache cache;
+
+            if (CachePath.empty() || !cache.Load(CachePath, sourceHash))
+                return false;
+            std::uint32_t nbLevels          = cache.NumberOfLevels(BodyCache::DISTANCE_BATCH);
+            std::uint32_t nbHierarchyLevels = cache.NumberOfLevels(BodyCache::HIERARCHY_TRIANGLES);
+
+            auto hierarchy      = std::make_shared<ParticleHierarchy>();
+            auto fastBendEdges  = std::make_shared<std::vector<std::array<int, 2>>>();
+            auto warpDirections = std::make_shared<std::vector<glm::vec3>>();
+
+            DistanceBatchesPerLevel.assign(nbLevels, {});
+            hierarchy->TrianglesPerLevel.assign(nbHierarchyLevels, {});
+            hierarchy->ParticleIndicesPerLevel.assign(nbHierarchyLevels, {});
+
+            bool isRead = nbLevels > 0 && nbHierarchyLevels > 0;
+
+            isRead = isRead && cache.Read(BodyCache::REST_POSITIONS, 0, RestPositions) && cache.Read(BodyCache::VERTEX_PARTICLES, 0, VertexParticles) && cache.Read(BodyCache::TRIANGLES, 0, Triangles);
+
+            for (std::uint32_t level = 0; level < nbLevels; level++)
+                isRead = isRead && cache.ReadBatch(BodyCache::DISTANCE_BATCH, level, DistanceBatchesPerLevel[level]);
+            for (std::uint32_t level = 0; level < nbHierarchyLevels; level++)
+                isRead = isRead && cache.Read(BodyCache::HIERARCHY_TRIANGLES, level, hierarchy->TrianglesPerLevel[level]) && cache.Read(BodyCache::HIERARCHY_PARTICLES, level, hierarchy->ParticleIndicesPerLevel[level]);
+            isRead = isRead && cache.ReadBatch(BodyCache::TRIANGLE_STRAIN_BATCH, 0, TriangleStrainBatch) && cache.ReadBatch(BodyCache::FAST_BEND_BATCH, 0, FastBendBatch);
+            isRead = isRead && cache.ReadBatch(BodyCache::DIHEDRAL_BEND_BATCH, 0, DihedralBendBatch) && cache.ReadBatch(BodyCache::ISOMETRIC_BEND_BATCH, 0, IsometricBendBatch);
+            isRead = isRead && cache.ReadBatch(BodyCache::VOLUME_BATCH, 0, VolumeBatch) && cache.ReadBatch(BodyCache::DEVIATORIC_BATCH, 0, DeviatoricBatch);
+            isRead = isRead && cache.Read(BodyCache::GLOBAL_VOLUMES, 0, GlobalVolumes);
+            isRead = isRead && cache.Read(BodyCache::FAST_BEND_EDGES, 0, *fastBendEdges) && fastBendEdges->size() == FastBendBatch.Size();
+            isRead = isRead && cache.Read(BodyCache::STRAIN_WARP_DIRECTIONS, 0, *warpDirections) && warpDirections->size() == TriangleStrainBatch.Size();
+
+            GlobalVolumeTriangles.assign(GlobalVolumes.size(), {});
+
+            for (std::uint32_t i = 0; i < GlobalVolumes.size(); i++)
+                isRead = isRead && cache.Read(BodyCache::GLOBAL_VOLUME_TRIANGLES, i, GlobalVolumeTriangles[i]);
+            if (!isRead) {
+                RestPositions.clear();
+                VertexParticles.clear();
+                Triangles.clear();
+                DistanceBatchesPerLevel.clear();
+                GlobalVolumes.clear();
+                GlobalVolumeTriangles.clear();
+
+                return false;
+            }
+
+            Hierarchy      = std::move(hierarchy);
+            FastBendEdges  = std::move(fastBendEdges);
+            WarpDirections = std::move(warpDirections);
+            SourceHash     = sourceHash;
+            IsFilled       = true;
+
+            return true;
+        }
+
+        void Save() const
+        {
+            if (CachePath.empty())
+                return;
+            BodyCache cache;
+
+            cache.Write(BodyCache::REST_POSITIONS, 0, RestPositions);
+            cache.Write(BodyCache::VERTEX_PARTICLES, 0, VertexParticles);
+            cache.Write(BodyCache::TRIANGLES, 0, Triangles);
+
+            for (std::uint32_t level = 0; level < DistanceBatchesPerLevel.size(); level++)
+                cache.WriteBatch(BodyCache::DISTANCE_BATCH, level, DistanceBatchesPerLevel[level]);
+            for (std::uint32_t level = 0; level < Hierarchy->TrianglesPerLevel.size(); level++) {
+                cache.Write(BodyCache::HIERARCHY_TRIANGLES, level, Hierarchy->TrianglesPerLevel[level]);
+                cache.Write(BodyCache::HIERARCHY_PARTICLES, level, Hierarchy->ParticleIndicesPerLevel[level]);
+            }
+
+            cache.WriteBatch(BodyCache::TRIANGLE_STRAIN_BATCH, 0, TriangleStrainBatch);
+            cache.WriteBatch(BodyCache::FAST_BEND_BATCH, 0, FastBendBatch);
+            cache.WriteBatch(BodyCache::DIHEDRAL_BEND_BATCH, 0, DihedralBendBatch);
+            cache.WriteBatch(BodyCache::ISOMETRIC_BEND_BATCH, 0, IsometricBendBatch);
+            cache.WriteBatch(BodyCache::VOLUME_BATCH, 0, VolumeBatch);
+            cache.WriteBatch(BodyCache::DEVIATORIC_BATCH, 0, DeviatoricBatch);
+            cache.Write(BodyCache::FAST_BEND_EDGES, 0, *FastBendEdges);
+            cache.Write(BodyCache::STRAIN_WARP_DIRECTIONS, 0, *WarpDirections);
+            cache.Write(BodyCache::GLOBAL_VOLUMES, 0, GlobalVolumes);
+
+            for (std::uint32_t i = 0; i < GlobalVolumeTriangles.size(); i++)
+                cache.Write(BodyCache::GLOBAL_VOLUME_TRIANGLES, i, GlobalVolumeTriangles[i]);
+            cache.Save(CachePath, SourceHash);
+        }
+    };
+};
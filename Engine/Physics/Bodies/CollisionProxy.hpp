@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Mesh/Decimator.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Decimated triangles a body collides through instead of a hierarchy level, rebuilt in the background after tears.
+    */
+    class CollisionProxy {
+
+        public:
+
+            CollisionProxy() = default;
+
+            ~CollisionProxy()
+            {
+                Wait();
+            }
+
+            CollisionProxy(const CollisionProxy &) = delete;
+            CollisionProxy &operator=(const CollisionProxy &) = delete;
+
+        public:
+
+            /**
+            * @brief Decimates the triangles to about nbTriangles now, 0 disabling the proxy.
+            */
+            void Build(std::size_t nbTriangles, const std::vector<glm::vec3> &restPositions, const std::vector<int> &triangles)
+            {
+                Wait();
+
+                _Size          = nbTriangles;
+                _IsInvalidated = false;
+
+                SetTriangles(nbTriangles > 0 ? Decimator::Decimate(restPositions, triangles, nbTriangles) : std::vector<int>(), restPositions.size());
+            }
+
+            void Invalidate()
+            {
+                _IsInvalidated = _Size > 0;
+            }
+
+            /**
+            * @brief Swaps in the triangles rebuilt since the last call, if done, and tells whether a rebuild should start.
+            */
+            bool Update()
+            {
+                if (_PendingTriangles.valid()) {
+                    if (_PendingTriangles.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                        return false;
+                    SetTriangles(_PendingTriangles.get(), _NbPendingParticles);
+                }
+
+                return _IsInvalidated;
+            }
+
+            void RebuildAsync(std::vector<glm::vec3> restPositions, std::vector<int> triangles)
+            {
+                _IsInvalidated      = false;
+                _NbPendingParticles = restPositions.size();
+
+                _PendingTriangles = std::async(std::launch::async, [restPositions = std::move(restPositions), triangles = std::move(triangles), nbTriangles = _Size]() {
+                    return Decimator::Decimate(restPositions, triangles, nbTriangles);
+                });
+            }
+
+            void Wait()
+            {
+                if (_PendingTriangles.valid())
+                    SetTriangles(_PendingTriangles.get(), _NbPendingParticles);
+            }
+
+            void RemapParticles(const std::vector<int> &newIndices)
+            {
+                Wait();
+
+                for (int& index : _Triangles)
+                    index = newIndices[index];
+                for (int& index : _Particles)
+                    index = newIndices[index];
+                std::sort(_Particles.begin(), _Particles.end());
+            }
+
+            bool IsEnabled() const
+            {
+                return _Size > 0;
+            }
+
+            const std::vector<int> &GetTriangles() const
+            {
+                return _Triangles;
+            }
+
+            /**
+            * @brief Particles used by the triangles, sorted.
+            */
+            const std::vector<int> &GetParticles() const
+            {
+                return _Particles;
+            }
+
+        private:
+
+            void SetTriangles(std::vector<int> triangles, std::size_t nbParticles)
+            {
+                _Triangles = std::move(triangles);
+                _Particles.clear();
+
+                std::vector<bool> isProxyParticle(nbParticles, false);
+
+                for (int particle : _Triangles)
+                    isProxyParticle[particle] = true;
+                for (std::size_t i = 0; i < nbParticles; i++)
+                    if (isProxyParticle[i])
+                        _Particles.push_back((int)i);
+            }
+
+        private:
+
+            std::size_t      _Size = 0;
+            std::vector<int> _Triangles;
+            std::vector<int> _Particles;
+
+            bool        _IsInvalidated      = false;
+            std::size_t _NbPendingParticles = 0;
+
+            std::future<std::vector<int>> _PendingTriangles;
+    };
+};
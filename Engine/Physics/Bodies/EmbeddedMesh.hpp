@@ -0,0 +1,249 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+#include "Particle/Particle.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "Utils/Utils.hpp"
+
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Render mesh finer than the simulation mesh of a body, skinned to its closest triangles at rest.
+    */
+    class EmbeddedMesh {
+
+        public:
+
+            /**
+            * @brief Binds the vertices of mesh to the triangles of the particles at restPositions.
+            */
+            EmbeddedMesh(std::shared_ptr<Mesh> mesh, const std::vector<glm::vec3> &restPositions, const std::vector<int> &triangles) : _Mesh(mesh)
+            {
+                Bind(restPositions, triangles);
+            }
+
+        public:
+
+            /**
+            * @brief Moves the render mesh with the particles, its positions relative to meshPosition like the body mesh.
+            */
+            void Skin(const std::vector<std::shared_ptr<Particle>> &particles, const std::vector<int> &triangles, const std::vector<glm::vec3> &particleNormals, glm::vec3 meshPosition)
+            {
+                auto& vertex = _Mesh->GetVertex();
+
+                _Mesh->Transform()->Position = meshPosition;
+
+                ThreadPool::Get().ParallelFor(_Bindings.size(), SKINNING_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; i++) {
+                        const Binding& binding = _Bindings[i];
+
+                        if (binding.Triangle < 0)
+                            continue;
+                        int i0 = triangles[3 * binding.Triangle], i1 = triangles[3 * binding.Triangle + 1], i2 = triangles[3 * binding.Triangle + 2];
+
+                        glm::vec3 p0 = particles[i0]->Position, p1 = particles[i1]->Position, p2 = particles[i2]->Position;
+
+                        glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+                        float     length     = glm::length(faceNormal);
+
+                        if (length > 1e-12f)
+                            faceNormal /= length;
+                        glm::vec3 position = binding.Barycentric.x * p0 + binding.Barycentric.y * p1 + binding.Barycentric.z * p2 + binding.Offset * faceNormal - meshPosition;
+                        glm::vec3 normal   = binding.Barycentric.x * particleNormals[i0] + binding.Barycentric.y * particleNormals[i1] + binding.Barycentric.z * particleNormals[i2];
+
+                        length = glm::length(normal);
+                        normal = length > 1e-12f ? normal / length : faceNormal;
+
+                        for (unsigned int k = 0; k < 3; k++) {
+                            vertex.Positions[3 * i + k] = position[k];
+                            vertex.Normals[3 * i + k]   = normal[k];
+                        }
+                    }
+                });
+
+                _Mesh->SendVertexDataToGPU();
+            }
+
+            std::shared_ptr<Mesh> GetMesh() const
+            {
+                return _Mesh;
+            }
+
+        private:
+
+            struct Binding {
+                int       Triangle    = -1;  // -1 when the body has no triangle to follow: the vertex stays where it is.
+                glm::vec3 Barycentric {};
+                float     Offset      = 0.0f;
+            };
+
+            void Bind(const std::vector<glm::vec3> &restPositions, const std::vector<int> &triangles)
+            {
+                std::size_t nbTriangles = triangles.size() / 3;
+
+                glm::vec3 lower(std::numeric_limits<float>::max());
+                glm::vec3 upper(std::numeric_limits<float>::lowest());
+
+                float edgeLengths = 0.0f;
+
+                for (std::size_t t = 0; t < nbTriangles; t++) {
+                    for (unsigned int k = 0; k < 3; k++) {
+                        glm::vec3 p = restPositions[triangles[3 * t + k]];
+
+                        lower = glm::min(lower, p);
+                        upper = glm::max(upper, p);
+
+                        edgeLengths += glm::distance(p, restPositions[triangles[3 * t + (k + 1) % 3]]);
+                    }
+                }
+
+                _CellSize   = nbTriangles > 0 ? std::max(edgeLengths / (3.0f * nbTriangles), 1e-6f) : 1.0f;
+                _Origin     = lower;
+                _Dimensions = nbTriangles > 0 ? glm::ivec3(glm::floor((upper - lower) / _CellSize)) + 1 : glm::ivec3(1);
+
+                std::vector<std::vector<int>> trianglesPerCell(_Dimensions.x * _Dimensions.y * _Dimensions.z);
+
+                for (std::size_t t = 0; t < nbTriangles; t++) {
+                    glm::vec3 p0 = restPositions[triangles[3 * t]], p1 = restPositions[triangles[3 * t + 1]], p2 = restPositions[triangles[3 * t + 2]];
+
+                    if (glm::length(glm::cross(p1 - p0, p2 - p0)) < 1e-12f)
+                        continue;  // No plane to project on.
+                    glm::ivec3 first = CellOf(glm::min(glm::min(p0, p1), p2));
+                    glm::ivec3 last  = CellOf(glm::max(glm::max(p0, p1), p2));
+
+                    for (int x = first.x; x <= last.x; x++)
+                        for (int y = first.y; y <= last.y; y++)
+                            for (int z = first.z; z <= last.z; z++)
+                                trianglesPerCell[CellIndex({ x, y, z })].push_back((int)t);
+                }
+
+                const auto& positions = _Mesh->GetVertex().Positions;
+
+                glm::vec3 meshPosition = _Mesh->Transform()->Position;
+
+                int maxRing = std::max(std::max(_Dimensions.x, _Dimensions.y), _Dimensions.z);
+
+                _Bindings.resize(positions.size() / 3);
+
+                ThreadPool::Get().ParallelFor(_Bindings.size(), BINDING_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; i++) {
+                        glm::vec3  p    = glm::vec3(positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]) + meshPosition;
+                        glm::ivec3 cell = CellOf(p);
+
+                        int   closestTriangle = -1;
+                        float closestDistance = std::numeric_limits<float>::max();
+
+                        // Rings of cells around p, until no closer triangle can be left.
+                        for (int ring = 0; ring <= maxRing; ring++) {
+                            ForEachCellOfRing(cell, ring, [&](std::size_t cellIndex) {
+                                for (int t : trianglesPerCell[cellIndex]) {
+                                    glm::vec3 closest = Utils::ClosestPointOnTriangle(p, restPositions[triangles[3 * t]], restPositions[triangles[3 * t + 1]], restPositions[triangles[3 * t + 2]]);
+
+                                    float distance = glm::distance(p, closest);
+
+                                    if (distance < closestDistance || (distance == closestDistance && t < closestTriangle)) {
+                                        closestDistance = distance;
+                                        closestTriangle = t;
+                                    }
+                                }
+                            });
+
+                            if (closestDistance <= DistanceBeyondRing(p, cell, ring))
+                                break;
+                        }
+
+                        _Bindings[i] = closestTriangle < 0 ? Binding {} : MakeBinding(p, closestTriangle, restPositions, triangles);
+                    }
+                });
+            }
+
+            /**
+            * @brief Unclamped barycentric coordinates of the projection of p on the triangle and the signed distance to its plane.
+            */
+            static Binding MakeBinding(glm::vec3 p, int triangle, const std::vector<glm::vec3> &restPositions, const std::vector<int> &triangles)
+            {
+                glm::vec3 p0 = restPositions[triangles[3 * triangle]], p1 = restPositions[triangles[3 * triangle + 1]], p2 = restPositions[triangles[3 * triangle + 2]];
+
+                glm::vec3 e0 = p1 - p0, e1 = p2 - p0, e2 = p - p0;
+
+                float d00 = glm::dot(e0, e0), d01 = glm::dot(e0, e1), d11 = glm::dot(e1, e1);
+                float d20 = glm::dot(e2, e0), d21 = glm::dot(e2, e1);
+
+                float denominator = d00 * d11 - d01 * d01;
+                float v           = (d11 * d20 - d01 * d21) / denominator;
+                float w           = (d00 * d21 - d01 * d20) / denominator;
+
+                return { triangle, glm::vec3(1.0f - v - w, v, w), glm::dot(e2, glm::normalize(glm::cross(e0, e1))) };
+            }
+
+            /**
+            * @brief Calls function on each grid cell exactly ring cells away from cell.
+            */
+            template<typename Function>
+            void ForEachCellOfRing(glm::ivec3 cell, int ring, Function &&function) const
+            {
+                glm::ivec3 first = glm::max(cell - ring, glm::ivec3(0));
+                glm::ivec3 last  = glm::min(cell + ring, _Dimensions - 1);
+
+                for (int x = first.x; x <= last.x; x++) {
+                    for (int y = first.y; y <= last.y; y++) {
+                        if (std::abs(x - cell.x) == ring || std::abs(y - cell.y) == ring) {
+                            for (int z = first.z; z <= last.z; z++)
+                                function(CellIndex({ x, y, z }));
+                            continue;
+                        }
+
+                        if (cell.z - ring >= 0)
+                            function(CellIndex({ x, y, cell.z - ring }));
+                        if (ring > 0 && cell.z + ring < _Dimensions.z)
+                            function(CellIndex({ x, y, cell.z + ring }));
+                    }
+                }
+            }
+
+            /**
+            * @brief Lower bound of the distance from p to the cells farther than ring cells from cell.
+            */
+            float DistanceBeyondRing(glm::vec3 p, glm::ivec3 cell, int ring) const
+            {
+                float distance = std::numeric_limits<float>::max();
+
+                for (int k = 0; k < 3; k++) {
+                    if (cell[k] + ring + 1 < _Dimensions[k])
+                        distance = std::min(distance, _Origin[k] + (cell[k] + ring + 1) * _CellSize - p[k]);
+                    if (cell[k] - ring - 1 >= 0)
+                        distance = std::min(distance, p[k] - (_Origin[k] + (cell[k] - ring) * _CellSize));
+                }
+
+                return distance;
+            }
+
+            glm::ivec3 CellOf(glm::vec3 p) const
+            {
+                return glm::clamp(glm::ivec3(glm::floor((p - _Origin) / _CellSize)), glm::ivec3(0), _Dimensions - 1);
+            }
+
+            std::size_t CellIndex(glm::ivec3 cell) const
+            {
+                return ((std::size_t)cell.z * _Dimensions.y + cell.y) * _Dimensions.x + cell.x;
+            }
+
+        private:
+
+            static constexpr std::size_t BINDING_GRAIN_SIZE  = 1024;
+            static constexpr std::size_t SKINNING_GRAIN_SIZE = 4096;
+
+            std::shared_ptr<Mesh> _Mesh;
+
+            std::vector<Binding> _Bindings;
+
+            glm::vec3  _Origin {};
+            glm::ivec3 _Dimensions {};
+            float      _CellSize = 1.0f;
+    };
+};
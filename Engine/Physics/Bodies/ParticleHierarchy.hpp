@@ -0,0 +1,193 @@
+#pragma once
+
+#include "Mesh/Vertex.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Coarser and coarser triangulations of the particles of a body, for its multilevel constraints and collisions.
+    */
+    struct ParticleHierarchy {
+
+        std::vector<std::vector<int>> TrianglesPerLevel;
+        std::vector<std::vector<int>> ParticleIndicesPerLevel;
+        std::vector<std::vector<int>> ClosestCoarseParticlesPerLevel;
+
+        /**
+        * @brief Builds nbLevels levels below the triangulation, positions holding x, y, z per particle.
+        */
+        static ParticleHierarchy Build(const std::vector<float> &positions, const std::vector<int> &triangles, int nbLevels)
+        {
+            ParticleHierarchy hierarchy;
+
+            Vertex particleVertex;  // The particles seen as a mesh, for Vertex::Subset.
+
+            particleVertex.Positions = positions;
+            particleVertex.Indices   = triangles;
+
+            int nbParticles = (int)(positions.size() / 3);
+
+            std::vector<int> allParticles(nbParticles);
+
+            for (int i = 0; i < nbParticles; i++)
+                allParticles[i] = i;
+            hierarchy.TrianglesPerLevel.push_back(triangles);
+            hierarchy.ParticleIndicesPerLevel.push_back(allParticles);
+            hierarchy.ClosestCoarseParticlesPerLevel.push_back(allParticles);
+
+            for (int level = 1; level <= nbLevels; level++) {
+                std::vector<int> coarseParticleIndices;
+                std::vector<int> closestCoarseParticleIndices;
+                std::vector<int> coarseTriangles;
+
+                particleVertex.Subset(hierarchy.TrianglesPerLevel.back(), coarseParticleIndices, closestCoarseParticleIndices, coarseTriangles);
+
+                hierarchy.TrianglesPerLevel.push_back(std::move(coarseTriangles));
+                hierarchy.ParticleIndicesPerLevel.push_back(std::move(coarseParticleIndices));
+                hierarchy.ClosestCoarseParticlesPerLevel.push_back(std::move(closestCoarseParticleIndices));
+            }
+
+            return hierarchy;
+        }
+
+        /**
+        * @brief Loads the hierarchy from cachePath when it matches, else builds and caches it; an empty path caches nothing.
+        */
+        static ParticleHierarchy LoadOrBuild(const std::vector<float> &positions, const std::vector<int> &triangles, int nbLevels, const std::string &cachePath)
+        {
+            std::uint64_t hash = Hash(positions, triangles, nbLevels);
+
+            ParticleHierarchy hierarchy;
+
+            if (!cachePath.empty() && hierarchy.Load(cachePath, hash))
+                return hierarchy;
+            hierarchy = Build(positions, triangles, nbLevels);
+
+            if (!cachePath.empty())
+                hierarchy.Save(cachePath, hash);
+            return hierarchy;
+        }
+
+        /**
+        * @brief Renumbers the particles, keeping those of each level sorted.
+        */
+        void Renumber(const std::vector<int> &newIndices)
+        {
+            for (auto& triangles : TrianglesPerLevel)
+                for (int& index : triangles)
+                    index = newIndices[index];
+            for (auto& particleIndices : ParticleIndicesPerLevel) {
+                for (int& index : particleIndices)
+                    index = newIndices[index];
+                std::sort(particleIndices.begin(), particleIndices.end());
+            }
+
+            for (auto& closestCoarseParticles : ClosestCoarseParticlesPerLevel) {
+                std::vector<int> renumbered(closestCoarseParticles.size(), -1);
+
+                for (std::size_t i = 0; i < closestCoarseParticles.size(); i++)
+                    renumbered[newIndices[i]] = closestCoarseParticles[i] < 0 ? -1 : newIndices[closestCoarseParticles[i]];
+                closestCoarseParticles = std::move(renumbered);
+            }
+        }
+
+        /**
+        * @brief FNV-1a of the positions, triangles and number of levels.
+        */
+        static std::uint64_t Hash(const std::vector<float> &positions, const std::vector<int> &triangles, int nbLevels)
+        {
+            std::uint64_t hash = 14695981039346656037ull;
+
+            auto addBytes = [&](const void *data, std::size_t size) {
+                for (std::size_t i = 0; i < size; i++)
+                    hash = (hash ^ ((const unsigned char *)data)[i]) * 1099511628211ull;
+            };
+
+            addBytes(positions.data(), positions.size() * sizeof(float));
+            addBytes(triangles.data(), triangles.size() * sizeof(int));
+            addBytes(&nbLevels, sizeof(nbLevels));
+
+            return hash;
+        }
+
+        bool Load(const std::string &path, std::uint64_t sourceHash)
+        {
+            std::ifstream reader(path, std::ios::binary);
+
+            if (!reader.is_open())
+                return false;
+            std::uint32_t magic = 0, version = 0;
+            std::uint64_t hash  = 0;
+
+            reader.read((char *)&magic, sizeof(magic));
+            reader.read((char *)&version, sizeof(version));
+            reader.read((char *)&hash, sizeof(hash));
+
+            if (!reader || magic != CACHE_MAGIC || version != CACHE_VERSION || hash != sourceHash)
+                return false;
+            for (auto *levels : { &TrianglesPerLevel, &ParticleIndicesPerLevel, &ClosestCoarseParticlesPerLevel }) {
+                std::uint64_t nbLevels = 0;
+
+                reader.read((char *)&nbLevels, sizeof(nbLevels));
+
+                if (!reader || nbLevels > MAX_LEVELS)
+                    return false;
+                levels->resize(nbLevels);
+
+                for (auto& level : *levels) {
+                    std::uint64_t size = 0;
+
+                    reader.read((char *)&size, sizeof(size));
+
+                    if (!reader)
+                        return false;
+                    level.resize(size);
+
+                    reader.read((char *)level.data(), size * sizeof(int));
+                }
+            }
+
+            return (bool)reader;
+        }
+
+        void Save(const std::string &path, std::uint64_t sourceHash) const
+        {
+            std::ofstream writer(path, std::ios::binary);
+
+            if (!writer.is_open()) {
+                std::cerr << "Could not write the particle hierarchy cache " << path << std::endl;
+
+                return;
+            }
+
+            writer.write((const char *)&CACHE_MAGIC, sizeof(CACHE_MAGIC));
+            writer.write((const char *)&CACHE_VERSION, sizeof(CACHE_VERSION));
+            writer.write((const char *)&sourceHash, sizeof(sourceHash));
+
+            for (const auto *levels : { &TrianglesPerLevel, &ParticleIndicesPerLevel, &ClosestCoarseParticlesPerLevel }) {
+                std::uint64_t nbLevels = levels->size();
+
+                writer.write((const char *)&nbLevels, sizeof(nbLevels));
+
+                for (const auto& level : *levels) {
+                    std::uint64_t size = level.size();
+
+                    writer.write((const char *)&size, sizeof(size));
+                    writer.write((const char *)level.data(), size * sizeof(int));
+                }
+            }
+        }
+
+        static constexpr std::uint32_t CACHE_MAGIC   = 0x48505845; // "EXPH"
+        static constexpr std::uint32_t CACHE_VERSION = 1;
+        static constexpr std::uint64_t MAX_LEVELS    = 64;
+    };
+};
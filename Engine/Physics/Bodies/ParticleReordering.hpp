@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Mesh/Ordering.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Order of the particles of a body (see Body::ReorderParticles).
+    */
+    enum ParticleOrdering {
+        ORDERING_NONE,
+        ORDERING_MORTON,
+        ORDERING_CUTHILL_MCKEE
+    };
+
+    class ParticleReordering {
+
+        public:
+
+            /**
+            * @brief Old indices of the particles in their new order, the graph being made of the triangles and constraints given.
+            */
+            template<typename... Constraints>
+            static std::vector<int> Order(ParticleOrdering ordering, const std::vector<glm::vec3> &restPositions, const std::vector<int> &triangles, const Constraints &...constraints)
+            {
+                if (ordering == ORDERING_MORTON)
+                    return Ordering::Morton(restPositions, restPositions.size());
+                return Ordering::ReverseCuthillMcKee(ConstraintGraph(restPositions.size(), triangles, constraints...));
+            }
+
+            /**
+            * @brief Particles sharing a triangle or a constraint, each list sorted.
+            */
+            template<typename... Constraints>
+            static std::vector<std::vector<int>> ConstraintGraph(std::size_t nbParticles, const std::vector<int> &triangles, const Constraints &...constraints)
+            {
+                std::vector<std::vector<int>> neighbors(nbParticles);
+
+                auto addClique = [&](const std::vector<int> &particles) {
+                    for (int a : particles)
+                        for (int b : particles)
+                            if (a != b)
+                                neighbors[a].push_back(b);
+                };
+
+                for (std::size_t i = 0; i + 2 < triangles.size(); i += 3)
+                    addClique({ triangles[i], triangles[i + 1], triangles[i + 2] });
+                auto addConstraints = [&](const auto &constraintList) {
+                    std::vector<int> particles;
+
+                    for (const auto& constraint : constraintList) {
+                        particles.clear();
+
+                        for (const auto& particle : constraint->GetParticles())
+                            particles.push_back((int)(particle->PositionIndex / 3));
+                        addClique(particles);
+                    }
+                };
+
+                (addConstraints(constraints), ...);
+
+                for (auto& particleNeighbors : neighbors) {
+                    std::sort(particleNeighbors.begin(), particleNeighbors.end());
+
+                    particleNeighbors.erase(std::unique(particleNeighbors.begin(), particleNeighbors.end()), particleNeighbors.end());
+                }
+
+                return neighbors;
+            }
+
+            /**
+            * @brief Sorts constraints by their first particle.
+            */
+            template<typename Constraints>
+            static void SortByParticles(Constraints &constraints)
+            {
+                std::vector<std::pair<unsigned long, std::size_t>> keys(constraints.size());
+
+                for (std::size_t c = 0; c < constraints.size(); c++) {
+                    keys[c] = { std::numeric_limits<unsigned long>::max(), c };
+
+                    for (const auto& particle : constraints[c]->GetParticles())
+                        keys[c].first = std::min(keys[c].first, particle->PositionIndex);
+                }
+
+                std::sort(keys.begin(), keys.end());
+
+                Constraints sorted;
+
+                sorted.reserve(constraints.size());
+
+                for (const auto& key : keys)
+                    sorted.push_back(std::move(constraints[key.second]));
+                constraints = std::move(sorted);
+            }
+    };
+};
@@ -1,78 +1,432 @@
 #pragma once
 
 #include "Body.hpp"
-#include "Constraints/VolumeConstraint.hpp"
+#include "Colliders/Collider.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "Utils/Utils.hpp"
+
+#include <cmath>
+#include <glm/gtc/quaternion.hpp>
 
 namespace Exodia {
 
+	/**
+	* @brief Body moving as a whole, its particles following the rest mesh through its pose; a null mass makes it static.
+	*/
 	class RigidBody : public Body {
 
 		public:
 
 			RigidBody(std::shared_ptr<Mesh> mesh, float mass) : Body(mesh, mass)
 			{
-				for (unsigned int i = 0; i < mesh->GetVertex().Indices.size(); i += 3) {
-					int index1 = mesh->GetVertex().Indices[i    ];
-					int index2 = mesh->GetVertex().Indices[i + 1];
-					int index3 = mesh->GetVertex().Indices[i + 2];
+				ComputeMassProperties();
+
+				_RestOffsets.reserve(_Particles.size());
+
+				for (const auto& particle : _Particles) {
+					particle->InverseMass = 0.0f;
 
-					std::shared_ptr<Particle> p1 = _Particles[index1];
-					std::shared_ptr<Particle> p2 = _Particles[index2];
-					std::shared_ptr<Particle> p3 = _Particles[index3];
+					_RestOffsets.push_back(particle->InitialPosition - _RestCenter);
 
-					AddDistanceConstraint(std::make_shared<DistanceConstraint>(p1, p2, 0.0f));
-					AddDistanceConstraint(std::make_shared<DistanceConstraint>(p2, p3, 0.0f));
-					AddDistanceConstraint(std::make_shared<DistanceConstraint>(p3, p1, 0.0f));
+					_BoundingRadius = std::max(_BoundingRadius, glm::length(_RestOffsets.back()));
 				}
 
-				for (unsigned int i = 0; i < _Particles.size(); i++) {
-					for (unsigned int j = 0; j < _Particles.size(); j++) {
-						if (glm::distance(_Particles[i]->Position, _Particles[j]->Position) < 0.001f)
-							AddDistanceConstraint(std::make_shared<DistanceConstraint>(_Particles[i], _Particles[j], 0.0f));
-					}
+				auto &vertex = mesh->GetVertex();
+
+				if (vertex.Normals.size() != vertex.Positions.size()) {
+					vertex.Normals.clear();
+					vertex.ComputeNormals();
 				}
+				_RestNormals = vertex.Normals;
 
-				std::map<std::pair<unsigned int, unsigned int>, std::vector<unsigned int>> edgeToTriangles;
+				Reset();
+			}
+
+		public:
 
-				for (unsigned int i = 0; i < mesh->GetVertex().Indices.size(); i += 3) {
-					int index1 = mesh->GetVertex().Indices[i    ];
-					int index2 = mesh->GetVertex().Indices[i + 1];
-					int index3 = mesh->GetVertex().Indices[i + 2];
+			bool IsRigid() const override
+			{
+				return true;
+			}
+
+			/**
+			* @brief Explicit step of the velocities and of the pose, then moves the particles to the predicted pose.
+			*/
+			void Integrate(float deltaTime, glm::vec3 acceleration)
+			{
+				_PreviousPosition    = _Position;
+				_PreviousOrientation = _Orientation;
+
+				if (IsStatic())
+					return;
+				_Velocity += deltaTime * acceleration;
+
+				// Gyroscopic term, the inertia being constant in the body frame only.
+				glm::mat3 rotation       = glm::mat3_cast(_Orientation);
+				glm::mat3 inertia        = rotation * _Inertia * glm::transpose(rotation);
+				glm::mat3 inverseInertia = rotation * _InverseInertia * glm::transpose(rotation);
+
+				_AngularVelocity -= deltaTime * inverseInertia * glm::cross(_AngularVelocity, inertia * _AngularVelocity);
+
+				_Velocity        *= 0.999f; // Same damping as the particles.
+				_AngularVelocity *= 0.999f;
+
+				_Position    += deltaTime * _Velocity;
+				_Orientation  = glm::normalize(_Orientation + 0.5f * deltaTime * glm::quat(0.0f, _AngularVelocity.x, _AngularVelocity.y, _AngularVelocity.z) * _Orientation);
+
+				UpdateRotation();
+				PlaceParticles(&Particle::PredictedPosition);
+			}
 
-					auto edge1 = std::pair<unsigned int, unsigned int>(std::min(index1, index2), std::max(index1, index2));
-					auto edge2 = std::pair<unsigned int, unsigned int>(std::min(index2, index3), std::max(index2, index3));
-					auto edge3 = std::pair<unsigned int, unsigned int>(std::min(index3, index1), std::max(index3, index1));
+			/**
+			* @brief Derives the velocities from the pose change of the substep, and moves the particles to the new pose.
+			*/
+			void UpdateVelocities(float deltaTime)
+			{
+				if (IsStatic())
+					return;
+				_Velocity = (_Position - _PreviousPosition) / deltaTime;
+
+				glm::quat change = _Orientation * glm::conjugate(_PreviousOrientation);
+
+				_AngularVelocity = 2.0f * glm::vec3(change.x, change.y, change.z) / deltaTime;
+
+				if (change.w < 0.0f)
+					_AngularVelocity = -_AngularVelocity;
+				PlaceParticles(&Particle::PredictedPosition);
+
+				ThreadPool::Get().ParallelFor(_Particles.size(), PARTICLE_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+					for (std::size_t i = begin; i < end; i++) {
+						_Particles[i]->Position = _Particles[i]->PredictedPosition;
+						_Particles[i]->Velocity = _Velocity + glm::cross(_AngularVelocity, _Rotation * _RestOffsets[i]);
+					}
+				});
+			}
+
+			/**
+			* @brief Inverse mass seen by a unit positional impulse along direction, applied at point (in world space).
+			*/
+			float GetGeneralizedInverseMass(glm::vec3 point, glm::vec3 direction) const
+			{
+				if (IsStatic())
+					return 0.0f;
+				glm::vec3 angular = glm::cross(point - _Position, direction);
+
+				return _InverseMass + glm::dot(angular, WorldInverseInertia() * angular);
+			}
+
+			void ApplyPositionalImpulse(glm::vec3 impulse, glm::vec3 point)
+			{
+				if (IsStatic())
+					return;
+				glm::vec3 angular = WorldInverseInertia() * glm::cross(point - _Position, impulse);
+
+				_Position    += _InverseMass * impulse;
+				_Orientation  = glm::normalize(_Orientation + 0.5f * glm::quat(0.0f, angular.x, angular.y, angular.z) * _Orientation);
+
+				UpdateRotation();
+			}
+
+			/**
+			* @brief Pulls the attached vertices toward their targets with positional impulses, the body turning as it is grabbed.
+			*/
+			void SolveAttachments(float deltaTime)
+			{
+				if (IsStatic())
+					return;
+				float deltaTime2 = deltaTime * deltaTime;
 
-					edgeToTriangles[edge1].push_back(i);
-					edgeToTriangles[edge2].push_back(i);
-					edgeToTriangles[edge3].push_back(i);
+				for (const auto& attachment : GetAttachments()) {
+					glm::mat3 rotation = glm::mat3_cast(attachment->GetOrientation());
+
+					const auto &indices     = attachment->GetParticleIndices();
+					const auto &compliances = attachment->GetCompliances();
+
+					for (std::size_t k = 0; k < indices.size(); k++) {
+						glm::vec3 point      = GetWorldVertex(indices[k]);
+						glm::vec3 correction = attachment->GetTarget(rotation, k) - point;
+
+						float distance = glm::length(correction);
+
+						if (distance < 1e-9f)
+							continue;
+						glm::vec3 direction = correction / distance;
+
+						float denominator = GetGeneralizedInverseMass(point, direction) + compliances[k] / deltaTime2;
+
+						if (denominator < 1e-6f)
+							continue;
+						ApplyPositionalImpulse((distance / denominator) * direction, point);
+					}
 				}
+			}
 
-				for (const auto& edgeToTrianglesPair : edgeToTriangles) {
-					auto edge      = edgeToTrianglesPair.first;
-					auto triangles = edgeToTrianglesPair.second;
+			/**
+			* @brief Pushes the vertices out of the static colliders one after the other, then applies their friction.
+			*/
+			void SolveColliderContacts(const std::vector<std::shared_ptr<Collider>> &colliders)
+			{
+				if (IsStatic())
+					return;
+				for (const auto& collider : colliders) {
+					glm::vec3 normal;
 
-					if (triangles.size() != 2)
+					if (collider->SignedDistance(_Position, normal) > _BoundingRadius + collider->GetThickness())
 						continue;
-					auto triangle1 = triangles[0];
-					auto triangle2 = triangles[1];
+					_ColliderContacts.clear();
 
-					std::vector<unsigned int> notSharedVertices;
+					for (std::size_t i = 0; i < _RestOffsets.size(); i++) {
+						glm::vec3 point = GetWorldVertex((int)i);
 
-					for (unsigned int i = 0; i < 3; i++) {
-						int index = mesh->GetVertex().Indices[triangle1 + i];
+						float penetration;
 
-						if (index != edge.first && index != edge.second)
-							notSharedVertices.push_back(index);
+						if (!collider->Contact(point, normal, penetration))
+							continue;
+						float denominator = GetGeneralizedInverseMass(point, normal);
+
+						if (denominator < 1e-6f)
+							continue;
+						ApplyPositionalImpulse((penetration / denominator) * normal, point);
+
+						_ColliderContacts.push_back({ (int)i, normal, penetration });
 					}
 
-					if (notSharedVertices.size() != 2)
-						continue;
-					AddBendConstraint(std::make_shared<FastBendConstraint>(_Particles[edge.first], _Particles[edge.second], _Particles[notSharedVertices[0]], _Particles[notSharedVertices[1]], 0.0f));
+					for (const auto& contact : _ColliderContacts) {
+						glm::vec3 point      = GetWorldVertex(contact.Vertex);
+						glm::vec3 correction = collider->FrictionCorrection(point - GetPreviousWorldPoint(point), contact.Normal, contact.Penetration);
+
+						float correctionLength = glm::length(correction);
+
+						if (correctionLength < 1e-9f)
+							continue;
+						float denominator = GetGeneralizedInverseMass(point, correction / correctionLength);
+
+						if (denominator < 1e-6f)
+							continue;
+						ApplyPositionalImpulse(-correction / denominator, point);
+					}
+				}
+			}
+
+			/**
+			* @brief Where a world point attached to the body was at the start of the substep.
+			*/
+			glm::vec3 GetPreviousWorldPoint(glm::vec3 point) const
+			{
+				glm::vec3 local = glm::transpose(_Rotation) * (point - _Position);
+
+				return _PreviousPosition + glm::mat3_cast(_PreviousOrientation) * local;
+			}
+
+			/**
+			* @brief Current world position of a vertex of the rest mesh.
+			*/
+			glm::vec3 GetWorldVertex(int index) const
+			{
+				return _Position + _Rotation * _RestOffsets[index];
+			}
+
+			/**
+			* @brief Rest mesh moved to the current pose: positions and normals are rotated, nothing is recomputed.
+			*/
+			void UpdateVertex() override
+			{
+				auto &vertex = _Mesh->GetVertex();
+
+				glm::vec3 meshPosition = Transform()->Position;
+
+				for (std::size_t i = 0; i < _VertexParticles.size(); i++) {
+					glm::vec3 position = _Particles[_VertexParticles[i]]->Position - meshPosition;
+					glm::vec3 normal   = _Rotation * glm::vec3(_RestNormals[3 * i], _RestNormals[3 * i + 1], _RestNormals[3 * i + 2]);
+
+					for (unsigned int k = 0; k < 3; k++) {
+						vertex.Positions[3 * i + k] = position[k];
+						vertex.Normals[3 * i + k]   = normal[k];
+					}
 				}
 
-				if (Utils::IsMergedTriangulationClosed(mesh->GetVertex().Indices, mesh->GetVertex().Positions))
-					AddGlobalVolumeConstraint(std::make_shared<GlobalVolumeConstraint>(_Particles, mesh->GetVertex().Indices, 1.0f, 0.0f));
+				UpdateParticleNormals();
+
+				SendVertexToGPU();
+			}
+
+			void Respawn(glm::vec3 position) override
+			{
+				_RestCenter += position - Transform()->Position;
+
+				Body::Respawn(position);
 			}
+
+			void Reset() override
+			{
+				_Position            = _RestCenter;
+				_PreviousPosition    = _RestCenter;
+				_Orientation         = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+				_PreviousOrientation = _Orientation;
+				_Velocity            = glm::vec3(0.0f);
+				_AngularVelocity     = glm::vec3(0.0f);
+
+				UpdateRotation();
+
+				for (const auto& particle : _Particles)
+					particle->Reset();
+				PlaceParticles(&Particle::PredictedPosition);
+			}
+
+		public:
+
+			glm::vec3 GetPosition() const
+			{
+				return _Position;
+			}
+
+			glm::quat GetOrientation() const
+			{
+				return _Orientation;
+			}
+
+			glm::vec3 GetVelocity() const
+			{
+				return _Velocity;
+			}
+
+			void SetVelocity(glm::vec3 velocity)
+			{
+				_Velocity = velocity;
+			}
+
+			glm::vec3 GetAngularVelocity() const
+			{
+				return _AngularVelocity;
+			}
+
+			void SetAngularVelocity(glm::vec3 angularVelocity)
+			{
+				_AngularVelocity = angularVelocity;
+			}
+
+			/**
+			* @brief Inertia tensor about the center of mass, in the body frame.
+			*/
+			const glm::mat3 &GetInertiaTensor() const
+			{
+				return _Inertia;
+			}
+
+		private:
+
+			/**
+			* @brief Center of mass and inertia tensor of the rest mesh, uniformly filled when closed, else with the mass on its vertices.
+			*/
+			void ComputeMassProperties()
+			{
+				std::size_t nbParticles = _Particles.size();
+
+				glm::vec3 reference(0.0f);
+
+				for (const auto& particle : _Particles)
+					reference += particle->InitialPosition;
+				reference /= (float)std::max<std::size_t>(nbParticles, 1);
+
+				// Mean of d and of d d^T over the body, d being the offset from the reference point.
+				glm::vec3 meanOffset(0.0f);
+				glm::mat3 meanOffsetSquared(0.0f);
+
+				bool isSolid = false;
+
+				if (Utils::IsTriangulationClosed(_Triangles)) {
+					const glm::mat3 canonical = glm::mat3(2.0f, 1.0f, 1.0f, 1.0f, 2.0f, 1.0f, 1.0f, 1.0f, 2.0f) / 120.0f;
+
+					float     volume = 0.0f;
+					glm::vec3 firstMoment(0.0f);
+					glm::mat3 secondMoment(0.0f);
+
+					for (std::size_t i = 0; i + 2 < _Triangles.size(); i += 3) {
+						glm::mat3 tetrahedron(_Particles[_Triangles[i    ]]->InitialPosition - reference,
+											  _Particles[_Triangles[i + 1]]->InitialPosition - reference,
+											  _Particles[_Triangles[i + 2]]->InitialPosition - reference);
+
+						float determinant = glm::determinant(tetrahedron);
+
+						volume       += determinant / 6.0f;
+						firstMoment  += determinant / 24.0f * (tetrahedron[0] + tetrahedron[1] + tetrahedron[2]);
+						secondMoment += determinant * tetrahedron * canonical * glm::transpose(tetrahedron);
+					}
+
+					if (std::fabs(volume) > 1e-9f) {
+						meanOffset        = firstMoment / volume;
+						meanOffsetSquared = secondMoment / volume;
+						isSolid           = true;
+					}
+				}
+
+				if (!isSolid) {
+					for (const auto& particle : _Particles) {
+						glm::vec3 offset = particle->InitialPosition - reference;
+
+						meanOffsetSquared += glm::outerProduct(offset, offset) / (float)nbParticles;
+					}
+				}
+
+				_RestCenter = reference + meanOffset;
+
+				glm::mat3 covariance = _Mass * (meanOffsetSquared - glm::outerProduct(meanOffset, meanOffset));
+
+				float trace = covariance[0][0] + covariance[1][1] + covariance[2][2];
+
+				_Inertia = trace * glm::mat3(1.0f) - covariance;
+
+				_InverseMass    = _Mass > 0.0f ? 1.0f / _Mass : 0.0f;
+				_InverseInertia = _Mass > 0.0f && std::fabs(glm::determinant(_Inertia)) > 1e-12f ? glm::inverse(_Inertia) : glm::mat3(0.0f);
+			}
+
+			glm::mat3 WorldInverseInertia() const
+			{
+				return _Rotation * _InverseInertia * glm::transpose(_Rotation);
+			}
+
+			void UpdateRotation()
+			{
+				_Rotation = glm::mat3_cast(_Orientation);
+			}
+
+			void PlaceParticles(glm::vec3 Particle::*position)
+			{
+				ThreadPool::Get().ParallelFor(_Particles.size(), PARTICLE_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+					for (std::size_t i = begin; i < end; i++)
+						(*_Particles[i]).*position = GetWorldVertex((int)i);
+				});
+			}
+
+		private:
+
+			struct ColliderContact {
+
+				int       Vertex;
+				glm::vec3 Normal;
+				float     Penetration;
+			};
+
+			static constexpr std::size_t PARTICLE_GRAIN_SIZE = 2048;
+
+			glm::vec3              _RestCenter {};
+			std::vector<glm::vec3> _RestOffsets;
+			std::vector<float>     _RestNormals;
+			float                  _BoundingRadius = 0.0f;
+
+			std::vector<ColliderContact> _ColliderContacts;
+
+			float     _InverseMass = 0.0f;
+			glm::mat3 _Inertia        { 0.0f };
+			glm::mat3 _InverseInertia { 0.0f };
+
+			glm::vec3 _Position            {};
+			glm::vec3 _PreviousPosition    {};
+			glm::quat _Orientation         { 1.0f, 0.0f, 0.0f, 0.0f };
+			glm::quat _PreviousOrientation { 1.0f, 0.0f, 0.0f, 0.0f };
+			glm::mat3 _Rotation            { 1.0f };
+
+			glm::vec3 _Velocity        {};
+			glm::vec3 _AngularVelocity {};
 	};
 };
@@ -1,83 +1,154 @@
 #include "Body.hpp"
+#include "Mesh/Topology.hpp"
+#include "Utils/ThreadPool.hpp"
 #include "Utils/Utils.hpp"
 
-#include <map>
+#include <array>
 #include <utility>
 
 namespace Exodia {
 
+    /**
+    * @brief Bend constraint put on every interior edge of a SoftBody.
+    */
+    enum BendingModel {
+        BENDING_FAST,
+        BENDING_DIHEDRAL,
+        BENDING_ISOMETRIC
+    };
+
+    /**
+    * @brief Stretch constraints: one distance per edge, or one strain per triangle warped along u.
+    */
+    enum StretchModel {
+        STRETCH_DISTANCE,
+        STRETCH_TRIANGLE
+    };
+
     class SoftBody : public Body {
 
         public:
 
-            SoftBody(std::shared_ptr<Mesh> mesh, float mass, float stretchCompliance = 0.0001f, float bendCompliance = 0.2f) : Body(mesh, mass)
+            /**
+            * @brief Bodies sharing a template share their constraints and hierarchy (see BodyTemplate).
+            */
+            SoftBody(std::shared_ptr<Mesh> mesh, float mass, float stretchCompliance = 0.0001f, float bendCompliance = 0.2f, BendingModel bendingModel = BENDING_FAST, StretchModel stretchModel = STRETCH_DISTANCE, glm::vec3 strainStiffness = glm::vec3(1.0f), std::shared_ptr<BodyTemplate> bodyTemplate = nullptr) : Body(mesh, mass, bodyTemplate, { stretchCompliance, bendCompliance, (float)bendingModel, (float)stretchModel, strainStiffness.x, strainStiffness.y, strainStiffness.z })
             {
-                for (unsigned int i = 0; i < mesh->GetVertex().Indices.size(); i += 3) {
-                    auto index1 = mesh->GetVertex().Indices[i];
-                    auto index2 = mesh->GetVertex().Indices[i + 1];
-                    auto index3 = mesh->GetVertex().Indices[i + 2];
-
-                    auto p1 = _Particles[index1];
-                    auto p2 = _Particles[index2];
-                    auto p3 = _Particles[index3];
-
-                    AddDistanceConstraint(std::make_shared<DistanceConstraint>(p1, p2, stretchCompliance));
-                    AddDistanceConstraint(std::make_shared<DistanceConstraint>(p2, p3, stretchCompliance));
-                    AddDistanceConstraint(std::make_shared<DistanceConstraint>(p3, p1, stretchCompliance));
-                }
+                if (IsFromTemplate())
+                    return;
+                std::size_t nbTriangles = _Triangles.size() / 3;
+
+                // An edge shared by two triangles is a hinge.
+                Topology topology(_Triangles, _Particles.size());
 
-                for (unsigned int i = 0; i < _Particles.size(); i++) {
-                    for (unsigned int j = i + 1; j < _Particles.size(); j++) {
-                        if (glm::distance(_Particles[i]->Position, _Particles[j]->Position) < 0.001f)
-                            AddDistanceConstraint(std::make_shared<DistanceConstraint>(_Particles[i], _Particles[j], 0.0f));
-                    }
+                std::vector<std::array<int, 4>> hinges;
+
+                for (std::size_t e = 0; e < topology.Edges.size(); e++) {
+                    if (topology.NumberOfHalfEdges(e) != 2)
+                        continue;
+                    int first  = topology.HalfEdges[topology.EdgeOffsets[e]];
+                    int second = topology.HalfEdges[topology.EdgeOffsets[e] + 1];
+
+                    std::array<int, 6> notSharedVertices;
+                    std::size_t        nbNotSharedVertices = 0;
+
+                    for (int halfEdge : { first, second })
+                        for (int corner = halfEdge - halfEdge % 3; corner < halfEdge - halfEdge % 3 + 3; corner++)
+                            if (_Triangles[corner] != topology.Edges[e][0] && _Triangles[corner] != topology.Edges[e][1])
+                                notSharedVertices[nbNotSharedVertices++] = _Triangles[corner];
+                    if (nbNotSharedVertices == 2)
+                        hinges.push_back({ topology.Edges[e][0], topology.Edges[e][1], notSharedVertices[0], notSharedVertices[1] });
                 }
 
-                std::map<std::pair<unsigned int, unsigned int>, std::vector<unsigned int>> edgeToTriangles;
+                if (stretchModel == STRETCH_TRIANGLE) {
+                    std::vector<std::shared_ptr<TriangleStrainConstraint>> strainConstraints(nbTriangles);
+
+                    ThreadPool::Get().ParallelFor(nbTriangles, CONSTRAINT_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                        for (std::size_t t = begin; t < end; t++) {
+                            glm::vec3 warpDirection = ComputeWarpDirection(mesh->GetVertex(), 3 * t);
 
-                for (unsigned int i = 0; i < mesh->GetVertex().Indices.size(); i += 3) {
-                    auto index1 = mesh->GetVertex().Indices[i    ];
-                    auto index2 = mesh->GetVertex().Indices[i + 1];
-                    auto index3 = mesh->GetVertex().Indices[i + 2];
+                            strainConstraints[t] = std::make_shared<TriangleStrainConstraint>(_Particles[_Triangles[3 * t]], _Particles[_Triangles[3 * t + 1]], _Particles[_Triangles[3 * t + 2]], stretchCompliance, strainStiffness, warpDirection);
+                        }
+                    });
 
-                    auto edge1 = std::pair<unsigned int, unsigned int>(std::min(index1, index2), std::max(index1, index2));
-                    auto edge2 = std::pair<unsigned int, unsigned int>(std::min(index2, index3), std::max(index2, index3));
-                    auto edge3 = std::pair<unsigned int, unsigned int>(std::min(index3, index1), std::max(index3, index1));
+                    for (const auto& constraint : strainConstraints)
+                        AddTriangleStrainConstraint(constraint);
+                } else {
+                    const auto& edges = topology.Edges;
 
-                    edgeToTriangles[edge1].push_back(i);
-                    edgeToTriangles[edge2].push_back(i);
-                    edgeToTriangles[edge3].push_back(i);
+                    std::vector<std::shared_ptr<DistanceConstraint>> distanceConstraints(edges.size());
+
+                    ThreadPool::Get().ParallelFor(edges.size(), CONSTRAINT_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                        for (std::size_t e = begin; e < end; e++)
+                            distanceConstraints[e] = std::make_shared<DistanceConstraint>(_Particles[edges[e][0]], _Particles[edges[e][1]], stretchCompliance);
+                    });
+
+                    for (const auto& constraint : distanceConstraints)
+                        AddDistanceConstraint(constraint);
                 }
 
-                for (const auto& edgeToTrianglesPair : edgeToTriangles) {
-                    auto edge      = edgeToTrianglesPair.first;
-                    auto triangles = edgeToTrianglesPair.second;
+                switch (bendingModel) {
+                    case BENDING_FAST:
+                        for (const auto& constraint : MakeHingeConstraints<FastBendConstraint>(hinges, bendCompliance))
+                            AddBendConstraint(constraint);
+                        break;
+                    case BENDING_DIHEDRAL:
+                        for (const auto& constraint : MakeHingeConstraints<DihedralBendConstraint>(hinges, bendCompliance))
+                            AddDihedralBendConstraint(constraint);
+                        break;
+                    case BENDING_ISOMETRIC:
+                        for (const auto& constraint : MakeHingeConstraints<IsometricBendConstraint>(hinges, bendCompliance))
+                            AddIsometricBendConstraint(constraint);
+                        break;
+                }
 
-                    if (triangles.size() != 2)
-                        continue;
-                    auto triangle1 = triangles[0];
-                    auto triangle2 = triangles[1];
+                if (!topology.Edges.empty() && topology.IsClosed())
+                    AddGlobalVolumeConstraint(std::make_shared<GlobalVolumeConstraint>(_Particles, _Triangles, 1.0f, 0.0f));
+                FillTemplate();
+            }
 
-                    std::vector<unsigned int> notSharedVertices;
+        private:
 
-                    for (unsigned int i = 0; i < 3; i++) {
-                        auto index = mesh->GetVertex().Indices[triangle1 + i];
+            /**
+            * @brief One constraint of type T per hinge (edge particles, then opposite particles), built in parallel.
+            */
+            template<typename T>
+            std::vector<std::shared_ptr<T>> MakeHingeConstraints(const std::vector<std::array<int, 4>> &hinges, float compliance) const
+            {
+                std::vector<std::shared_ptr<T>> constraints(hinges.size());
 
-                        if (index != edge.first && index != edge.second)
-                            notSharedVertices.push_back(index);
-                        index = mesh->GetVertex().Indices[triangle2 + i];
+                ThreadPool::Get().ParallelFor(hinges.size(), CONSTRAINT_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t h = begin; h < end; h++)
+                        constraints[h] = std::make_shared<T>(_Particles[hinges[h][0]], _Particles[hinges[h][1]], _Particles[hinges[h][2]], _Particles[hinges[h][3]], compliance);
+                });
 
-                        if (index != edge.first && index != edge.second)
-                            notSharedVertices.push_back(index);
-                    }
+                return constraints;
+            }
 
-                    if (notSharedVertices.size() != 2)
-                        continue;
-                    AddBendConstraint(std::make_shared<FastBendConstraint>(_Particles[edge.first], _Particles[edge.second], _Particles[notSharedVertices[0]], _Particles[notSharedVertices[1]], bendCompliance));
-                }
+            /**
+            * @brief Direction of increasing u over the triangle at offset, null when the mesh has no usable UVs.
+            */
+            glm::vec3 ComputeWarpDirection(const Vertex &vertex, unsigned int offset) const
+            {
+                if (vertex.UVs.size() / 2 != _VertexParticles.size())
+                    return glm::vec3(0.0f);
+                int index1 = vertex.Indices[offset    ];
+                int index2 = vertex.Indices[offset + 1];
+                int index3 = vertex.Indices[offset + 2];
+
+                glm::vec3 e1 = _Particles[_Triangles[offset + 1]]->Position - _Particles[_Triangles[offset]]->Position;
+                glm::vec3 e2 = _Particles[_Triangles[offset + 2]]->Position - _Particles[_Triangles[offset]]->Position;
+
+                glm::vec2 uv1 = { vertex.UVs[index2 * 2] - vertex.UVs[index1 * 2], vertex.UVs[index2 * 2 + 1] - vertex.UVs[index1 * 2 + 1] };
+                glm::vec2 uv2 = { vertex.UVs[index3 * 2] - vertex.UVs[index1 * 2], vertex.UVs[index3 * 2 + 1] - vertex.UVs[index1 * 2 + 1] };
 
-                if (Utils::IsMergedTriangulationClosed(mesh->GetVertex().Indices, mesh->GetVertex().Positions))
-                    AddGlobalVolumeConstraint(std::make_shared<GlobalVolumeConstraint>(_Particles, mesh->GetVertex().Indices, 1.0f, 0.0f));
+                float determinant = uv1.x * uv2.y - uv2.x * uv1.y;
+
+                if (determinant == 0.0f)
+                    return glm::vec3(0.0f);
+                return (e1 * uv2.y - e2 * uv1.y) / determinant;
             }
+
+            static constexpr std::size_t CONSTRAINT_GRAIN_SIZE = 4096;
     };
 };
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Body.hpp"
+#include "Mesh/Tetrahedralizer.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "Utils/Utils.hpp"
+
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+namespace Exodia {
+
+    /**
+    * @brief Soft body filled with tetrahedra, each keeping its volume and shape.
+    */
+    class TetrahedralBody : public Body {
+
+        public:
+
+            /**
+            * @brief resolution is the number of interior grid cells along the largest side; the mesh must be closed.
+            */
+            TetrahedralBody(std::shared_ptr<Mesh> mesh, float mass, int resolution = 8, float volumeCompliance = 0.0f, float deviatoricCompliance = 0.001f, std::shared_ptr<BodyTemplate> bodyTemplate = nullptr) : Body(mesh, mass, bodyTemplate, { (float)resolution, volumeCompliance, deviatoricCompliance })
+            {
+                if (IsFromTemplate())
+                    return;
+                std::vector<int> triangles = _Triangles;
+
+                if (!Utils::IsTriangulationClosed(triangles))
+                    throw std::runtime_error("A tetrahedral body needs a closed mesh.");
+                std::size_t nbSurfaceParticles = _Particles.size();
+
+                std::vector<glm::vec3> surfacePositions(nbSurfaceParticles);
+                std::vector<glm::vec3> interiorPositions;
+
+                for (std::size_t i = 0; i < nbSurfaceParticles; i++)
+                    surfacePositions[i] = _Particles[i]->InitialPosition;
+                auto tetrahedra = Tetrahedralizer::Tetrahedralize(surfacePositions, _Triangles, resolution, interiorPositions);
+
+                for (const auto& position : interiorPositions)
+                    _Particles.push_back(std::make_shared<Particle>(0.0f, position, 3 * _Particles.size()));
+                for (const auto& particle : _Particles) {
+                    particle->Mass        = mass / (float)_Particles.size();
+                    particle->InverseMass = particle->Mass == 0.0f ? 0.0f : 1.0f / particle->Mass;
+                }
+                UpdateParticleNormals();
+
+                std::vector<std::shared_ptr<VolumeConstraint>>     volumeConstraints(tetrahedra.size());
+                std::vector<std::shared_ptr<DeviatoricConstraint>> deviatoricConstraints(tetrahedra.size());
+
+                ThreadPool::Get().ParallelFor(tetrahedra.size(), CONSTRAINT_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t t = begin; t < end; t++) {
+                        const auto& p = Corners(tetrahedra[t]);
+
+                        float restVolume = glm::dot(glm::cross(p[1]->Position - p[0]->Position, p[2]->Position - p[0]->Position), p[3]->Position - p[0]->Position) / 6.0f;
+
+                        volumeConstraints[t]     = std::make_shared<VolumeConstraint>(p[0], p[1], p[2], p[3], restVolume, volumeCompliance * restVolume);
+                        deviatoricConstraints[t] = std::make_shared<DeviatoricConstraint>(p[0], p[1], p[2], p[3], deviatoricCompliance / restVolume);
+                    }
+                });
+
+                for (std::size_t t = 0; t < tetrahedra.size(); t++) {
+                    AddVolumeConstraint(volumeConstraints[t]);
+                    AddDeviatoricConstraint(deviatoricConstraints[t]);
+                }
+
+                TieLeftOutParticles(tetrahedra, nbSurfaceParticles);
+                FillTemplate();
+            }
+
+        public:
+
+            /**
+            * @brief Tears split surface particles only, which would leave the tetrahedra behind.
+            */
+            bool CanTear() const override
+            {
+                return false;
+            }
+
+        private:
+
+            std::array<std::shared_ptr<Particle>, 4> Corners(const std::array<int, 4> &tetrahedron) const
+            {
+                return { _Particles[tetrahedron[0]], _Particles[tetrahedron[1]], _Particles[tetrahedron[2]], _Particles[tetrahedron[3]] };
+            }
+
+            /**
+            * @brief Ties each particle in no tetrahedron to the corners of the tetrahedron of closest centroid.
+            */
+            void TieLeftOutParticles(const std::vector<std::array<int, 4>> &tetrahedra, std::size_t nbSurfaceParticles)
+            {
+                if (tetrahedra.empty())
+                    return;
+                std::vector<bool> isInTetrahedron(nbSurfaceParticles, false);
+
+                for (const auto& tetrahedron : tetrahedra)
+                    for (int corner : tetrahedron)
+                        if (corner < (int)nbSurfaceParticles)
+                            isInTetrahedron[corner] = true;
+                for (std::size_t i = 0; i < nbSurfaceParticles; i++) {
+                    if (isInTetrahedron[i])
+                        continue;
+                    std::size_t closestTetrahedron = 0;
+                    float       closestDistance    = std::numeric_limits<float>::max();
+
+                    for (std::size_t t = 0; t < tetrahedra.size(); t++) {
+                        glm::vec3 centroid(0.0f);
+
+                        for (const auto& corner : Corners(tetrahedra[t]))
+                            centroid += 0.25f * corner->Position;
+                        float distance = glm::distance(centroid, _Particles[i]->Position);
+
+                        if (distance < closestDistance) {
+                            closestDistance    = distance;
+                            closestTetrahedron = t;
+                        }
+                    }
+
+                    for (const auto& corner : Corners(tetrahedra[closestTetrahedron]))
+                        AddDistanceConstraint(std::make_shared<DistanceConstraint>(_Particles[i], corner, 0.0f));
+                }
+            }
+
+            static constexpr std::size_t CONSTRAINT_GRAIN_SIZE = 4096;
+    };
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Collider.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace Exodia {
+
+    /**
+    * @brief Oriented box, given by its center, its half extents along its axes, and its orientation.
+    */
+    class BoxCollider : public Collider {
+
+        public:
+
+            BoxCollider(glm::vec3 center, glm::vec3 halfExtents, glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f)) : _Center(center), _HalfExtents(halfExtents), _Rotation(glm::mat3_cast(glm::normalize(orientation))) {};
+
+        public:
+
+            float SignedDistance(glm::vec3 point, glm::vec3 &normal) const override
+            {
+                glm::vec3 local  = glm::transpose(_Rotation) * (point - _Center);
+                glm::vec3 excess = glm::abs(local) - _HalfExtents;
+                glm::vec3 sign   = glm::vec3(local.x < 0.0f ? -1.0f : 1.0f, local.y < 0.0f ? -1.0f : 1.0f, local.z < 0.0f ? -1.0f : 1.0f);
+
+                glm::vec3 outside = glm::max(excess, glm::vec3(0.0f));
+
+                float outsideDistance = glm::length(outside);
+
+                if (outsideDistance > 0.0f) {
+                    normal = _Rotation * (sign * outside / outsideDistance);
+
+                    return outsideDistance;
+                }
+
+                // Inside: the closest face is the one of the largest (least negative) excess.
+                int axis = excess.x > excess.y ? (excess.x > excess.z ? 0 : 2) : (excess.y > excess.z ? 1 : 2);
+
+                glm::vec3 localNormal(0.0f);
+
+                localNormal[axis] = sign[axis];
+
+                normal = _Rotation * localNormal;
+
+                return excess[axis];
+            }
+
+        private:
+
+            glm::vec3 _Center;
+            glm::vec3 _HalfExtents;
+            glm::mat3 _Rotation;
+    };
+};
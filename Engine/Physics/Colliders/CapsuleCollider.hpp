@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Collider.hpp"
+
+#include <algorithm>
+
+namespace Exodia {
+
+    /**
+    * @brief Points within radius of the segment [a, b].
+    */
+    class CapsuleCollider : public Collider {
+
+        public:
+
+            CapsuleCollider(glm::vec3 a, glm::vec3 b, float radius) : _A(a), _B(b), _Radius(radius) {};
+
+        public:
+
+            float SignedDistance(glm::vec3 point, glm::vec3 &normal) const override
+            {
+                glm::vec3 axis = _B - _A;
+
+                float axisLength2 = glm::dot(axis, axis);
+                float t           = axisLength2 > 1e-12f ? std::clamp(glm::dot(point - _A, axis) / axisLength2, 0.0f, 1.0f) : 0.0f;
+
+                glm::vec3 offset = point - (_A + t * axis);
+
+                float distance = glm::length(offset);
+
+                normal = distance > 1e-6f ? offset / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+
+                return distance - _Radius;
+            }
+
+        private:
+
+            glm::vec3 _A;
+            glm::vec3 _B;
+            float     _Radius;
+    };
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <stdexcept>
+
+namespace Exodia {
+
+    /**
+    * @brief Static obstacle given by a signed distance, with friction.
+    */
+    class Collider {
+
+        public:
+
+            virtual ~Collider() = default;
+
+            /**
+            * @brief Signed distance from point to the surface, negative inside, and the outward normal.
+            */
+            virtual float SignedDistance(glm::vec3 point, glm::vec3 &normal) const = 0;
+
+        public:
+
+            /**
+            * @brief Whether point is closer than the thickness to the surface, with the normal and depth to push it out.
+            */
+            bool Contact(glm::vec3 point, glm::vec3 &normal, float &penetration) const
+            {
+                penetration = _H - SignedDistance(point, normal);
+
+                return penetration > 0.0f && glm::dot(normal, normal) > 0.0f;
+            }
+
+            /**
+            * @brief Moves position (reached from previousPosition during the substep) out of the collider, with friction.
+            */
+            void Project(glm::vec3 &position, glm::vec3 previousPosition) const
+            {
+                glm::vec3 normal;
+                float     penetration;
+
+                if (!Contact(position, normal, penetration))
+                    return;
+                position += penetration * normal;
+                position -= FrictionCorrection(position - previousPosition, normal, penetration);
+            }
+
+            /**
+            * @brief Part of motion, relative to the collider, that friction removes for a contact.
+            */
+            glm::vec3 FrictionCorrection(glm::vec3 motion, glm::vec3 normal, float penetration) const
+            {
+                glm::vec3 slip = motion - glm::dot(motion, normal) * normal;
+
+                float slipLength = glm::length(slip);
+
+                if (slipLength < _StaticFriction * penetration)
+                    return slip;
+                return std::min(_DynamicFriction * penetration / slipLength, 1.0f) * slip;
+            }
+
+            void SetFriction(float staticFriction, float dynamicFriction)
+            {
+                if (staticFriction < 0.0f || dynamicFriction < 0.0f)
+                    throw std::runtime_error("Invalid collider friction. Must be positive.");
+                _StaticFriction  = staticFriction;
+                _DynamicFriction = dynamicFriction;
+            }
+
+            float GetThickness() const
+            {
+                return _H;
+            }
+
+        protected:
+
+            float _H               = 0.02f; // Same thickness as the collision constraints.
+            float _StaticFriction  = 0.5f;
+            float _DynamicFriction = 0.3f;
+    };
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Collider.hpp"
+
+namespace Exodia {
+
+    /**
+    * @brief Infinite plane through point, the half-space behind normal being solid.
+    */
+    class PlaneCollider : public Collider {
+
+        public:
+
+            PlaneCollider(glm::vec3 point, glm::vec3 normal) : _Point(point), _Normal(glm::normalize(normal)) {};
+
+        public:
+
+            float SignedDistance(glm::vec3 point, glm::vec3 &normal) const override
+            {
+                normal = _Normal;
+
+                return glm::dot(point - _Point, _Normal);
+            }
+
+        private:
+
+            glm::vec3 _Point;
+            glm::vec3 _Normal;
+    };
+};
@@ -0,0 +1,411 @@
+#pragma once
+
+#include "Collider.hpp"
+#include "Mesh/Mesh.hpp"
+#include "Utils/ThreadPool.hpp"
+#include "Utils/Utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Static mesh baked into a narrow band signed distance grid, optionally cached to disk.
+    */
+    class SDFCollider : public Collider {
+
+        public:
+
+            SDFCollider(std::shared_ptr<Mesh> mesh, float cellSize, const std::string &cachePath = "") : _CellSize(cellSize)
+            {
+                if (cellSize <= 0.0f)
+                    throw std::runtime_error("Invalid SDF cell size. Must be positive.");
+                std::vector<glm::vec3> triangles = WorldTriangles(*mesh);
+
+                if (triangles.empty())
+                    throw std::runtime_error("Cannot build a SDF collider from a mesh without triangles.");
+                _SourceHash = Hash(triangles);
+
+                if (!cachePath.empty() && Load(cachePath))
+                    return;
+                Bake(triangles, Utils::IsMergedTriangulationClosed(mesh->GetVertex().Indices, mesh->GetVertex().Positions));
+
+                if (!cachePath.empty())
+                    Save(cachePath);
+            }
+
+        public:
+
+            float SignedDistance(glm::vec3 point, glm::vec3 &normal) const override
+            {
+                glm::vec3 local = (point - _Origin) / _CellSize;
+                glm::vec3 upper = glm::vec3(_Dimensions - 1);
+
+                // Beyond the grid, only the distance to it is known: farther than the band anyway.
+                glm::vec3 outside = glm::max(glm::max(-local, local - upper), glm::vec3(0.0f));
+
+                if (outside.x > 0.0f || outside.y > 0.0f || outside.z > 0.0f) {
+                    normal = glm::vec3(0.0f);
+
+                    return _Band + _CellSize * glm::length(outside);
+                }
+
+                glm::ivec3 node     = glm::min(glm::ivec3(glm::floor(local)), _Dimensions - 2);
+                glm::vec3  fraction = local - glm::vec3(node);
+
+                float c[2][2][2];
+
+                for (int i = 0; i < 2; i++)
+                    for (int j = 0; j < 2; j++)
+                        for (int k = 0; k < 2; k++)
+                            c[i][j][k] = GetNode(node.x + i, node.y + j, node.z + k);
+
+                // Interpolation along z, then y, then x, the gradient following each step.
+                float c00 = c[0][0][0] + fraction.z * (c[0][0][1] - c[0][0][0]);
+                float c01 = c[0][1][0] + fraction.z * (c[0][1][1] - c[0][1][0]);
+                float c10 = c[1][0][0] + fraction.z * (c[1][0][1] - c[1][0][0]);
+                float c11 = c[1][1][0] + fraction.z * (c[1][1][1] - c[1][1][0]);
+
+                float c0 = c00 + fraction.y * (c01 - c00);
+                float c1 = c10 + fraction.y * (c11 - c10);
+
+                glm::vec3 gradient;
+
+                gradient.x = c1 - c0;
+                gradient.y = (c01 - c00) + fraction.x * ((c11 - c10) - (c01 - c00));
+
+                float dz00 = c[0][0][1] - c[0][0][0];
+                float dz01 = c[0][1][1] - c[0][1][0];
+                float dz10 = c[1][0][1] - c[1][0][0];
+                float dz11 = c[1][1][1] - c[1][1][0];
+
+                float dz0 = dz00 + fraction.y * (dz01 - dz00);
+                float dz1 = dz10 + fraction.y * (dz11 - dz10);
+
+                gradient.z = dz0 + fraction.x * (dz1 - dz0);
+
+                float gradientLength = glm::length(gradient);
+
+                normal = gradientLength > 1e-6f ? gradient / gradientLength : glm::vec3(0.0f);
+
+                return c0 + fraction.x * (c1 - c0);
+            }
+
+            /**
+            * @brief Number of bricks holding distances, the others being uniform.
+            */
+            std::size_t GetBrickCount() const
+            {
+                return _BrickValues.size() / BRICK_NODES;
+            }
+
+        private:
+
+            static std::vector<glm::vec3> WorldTriangles(Mesh &mesh)
+            {
+                auto &vertex = mesh.GetVertex();
+
+                glm::mat4 worldMatrix = mesh.Transform()->ComputeWorldMatrix();
+
+                std::vector<glm::vec3> triangles;
+
+                triangles.reserve(vertex.Indices.size());
+
+                for (std::size_t i = 0; i + 2 < vertex.Indices.size(); i += 3) {
+                    for (unsigned int k = 0; k < 3; k++) {
+                        int index = vertex.Indices[i + k];
+
+                        triangles.push_back(glm::vec3(worldMatrix * glm::vec4(vertex.Positions[3 * index], vertex.Positions[3 * index + 1], vertex.Positions[3 * index + 2], 1.0f)));
+                    }
+                }
+
+                return triangles;
+            }
+
+            void Bake(const std::vector<glm::vec3> &triangles, bool isClosed)
+            {
+                _Band = BAND_CELLS * _CellSize;
+
+                glm::vec3 lower(std::numeric_limits<float>::max());
+                glm::vec3 upper(std::numeric_limits<float>::lowest());
+
+                for (const auto &position : triangles) {
+                    lower = glm::min(lower, position);
+                    upper = glm::max(upper, position);
+                }
+
+                _Origin = lower - glm::vec3(_Band + _CellSize);
+
+                glm::ivec3 nbCells = glm::ivec3(glm::ceil((upper - lower + glm::vec3(2.0f * (_Band + _CellSize))) / _CellSize));
+
+                _BrickDimensions = (nbCells + BRICK_SIZE) / BRICK_SIZE;
+                _Dimensions      = _BrickDimensions * BRICK_SIZE;
+
+                std::vector<bool> isInside = isClosed ? ComputeInsideNodes(triangles) : std::vector<bool>();
+
+                // Triangles touching each brick, the brick being grown by the band.
+                std::vector<std::vector<int>> trianglesPerBrick(BrickCount());
+
+                for (std::size_t t = 0; t < triangles.size() / 3; t++) {
+                    glm::vec3 triangleLower = glm::min(glm::min(triangles[3 * t], triangles[3 * t + 1]), triangles[3 * t + 2]) - glm::vec3(_Band);
+                    glm::vec3 triangleUpper = glm::max(glm::max(triangles[3 * t], triangles[3 * t + 1]), triangles[3 * t + 2]) + glm::vec3(_Band);
+
+                    glm::ivec3 first = glm::max(glm::ivec3(glm::floor((triangleLower - _Origin) / _CellSize)) / BRICK_SIZE, glm::ivec3(0));
+                    glm::ivec3 last  = glm::min(glm::ivec3(glm::floor((triangleUpper - _Origin) / _CellSize)) / BRICK_SIZE, _BrickDimensions - 1);
+
+                    for (int bx = first.x; bx <= last.x; bx++)
+                        for (int by = first.y; by <= last.y; by++)
+                            for (int bz = first.z; bz <= last.z; bz++)
+                                trianglesPerBrick[BrickIndex(bx, by, bz)].push_back((int)t);
+                }
+
+                _BrickIndices.assign(BrickCount(), UNIFORM_OUTSIDE);
+
+                std::vector<std::size_t> bandBricks;
+
+                for (std::size_t brick = 0; brick < BrickCount(); brick++) {
+                    if (!trianglesPerBrick[brick].empty()) {
+                        _BrickIndices[brick] = (int)bandBricks.size();
+
+                        bandBricks.push_back(brick);
+                    } else if (isClosed) {
+                        glm::ivec3 center = BrickCoordinates(brick) * BRICK_SIZE + BRICK_SIZE / 2;
+
+                        if (isInside[NodeIndex(center.x, center.y, center.z)])
+                            _BrickIndices[brick] = UNIFORM_INSIDE;
+                    }
+                }
+
+                _BrickValues.assign(bandBricks.size() * BRICK_NODES, 0.0f);
+
+                ThreadPool::Get().ParallelFor(bandBricks.size(), 1, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t b = begin; b < end; b++) {
+                        std::size_t brick = bandBricks[b];
+                        glm::ivec3  base  = BrickCoordinates(brick) * BRICK_SIZE;
+
+                        for (int k = 0; k < BRICK_NODES; k++) {
+                            glm::ivec3 node  = base + glm::ivec3(k % BRICK_SIZE, (k / BRICK_SIZE) % BRICK_SIZE, k / (BRICK_SIZE * BRICK_SIZE));
+                            glm::vec3  point = _Origin + _CellSize * glm::vec3(node);
+
+                            float distance    = std::numeric_limits<float>::max();
+                            float closestSide = 1.0f;
+
+                            for (int t : trianglesPerBrick[brick]) {
+                                glm::vec3 closest = Utils::ClosestPointOnTriangle(point, triangles[3 * t], triangles[3 * t + 1], triangles[3 * t + 2]);
+
+                                float triangleDistance = glm::length(point - closest);
+
+                                if (triangleDistance < distance) {
+                                    distance    = triangleDistance;
+                                    closestSide = glm::dot(point - closest, glm::cross(triangles[3 * t + 1] - triangles[3 * t], triangles[3 * t + 2] - triangles[3 * t]));
+                                }
+                            }
+
+                            bool inside = isClosed ? (bool)isInside[NodeIndex(node.x, node.y, node.z)] : closestSide < 0.0f;
+
+                            distance = std::min(distance, _Band);
+
+                            _BrickValues[b * BRICK_NODES + k] = inside ? -distance : distance;
+                        }
+                    }
+                });
+            }
+
+            /**
+            * @brief Inside flag of every node, by parity of the crossings of a ray along z.
+            */
+            std::vector<bool> ComputeInsideNodes(const std::vector<glm::vec3> &triangles) const
+            {
+                const glm::vec2 shift = _CellSize * glm::vec2(0.0137f, 0.0291f);
+
+                std::vector<std::vector<float>> crossingsPerColumn(_Dimensions.x * _Dimensions.y);
+
+                for (std::size_t t = 0; t < triangles.size() / 3; t++) {
+                    glm::vec3 a = triangles[3 * t], b = triangles[3 * t + 1], c = triangles[3 * t + 2];
+
+                    glm::vec2 lower = glm::min(glm::min(glm::vec2(a), glm::vec2(b)), glm::vec2(c));
+                    glm::vec2 upper = glm::max(glm::max(glm::vec2(a), glm::vec2(b)), glm::vec2(c));
+
+                    glm::ivec2 first = glm::max(glm::ivec2(glm::ceil((lower - glm::vec2(_Origin) - shift) / _CellSize)), glm::ivec2(0));
+                    glm::ivec2 last  = glm::min(glm::ivec2(glm::floor((upper - glm::vec2(_Origin) - shift) / _CellSize)), glm::ivec2(_Dimensions) - 1);
+
+                    float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+
+                    if (std::fabs(area) < 1e-12f)
+                        continue;
+                    for (int i = first.x; i <= last.x; i++) {
+                        for (int j = first.y; j <= last.y; j++) {
+                            glm::vec2 p = glm::vec2(_Origin) + shift + _CellSize * glm::vec2(i, j);
+
+                            float u = ((b.x - p.x) * (c.y - p.y) - (c.x - p.x) * (b.y - p.y)) / area;
+                            float v = ((c.x - p.x) * (a.y - p.y) - (a.x - p.x) * (c.y - p.y)) / area;
+                            float w = 1.0f - u - v;
+
+                            if (u < 0.0f || v < 0.0f || w < 0.0f)
+                                continue;
+                            crossingsPerColumn[j * _Dimensions.x + i].push_back(u * a.z + v * b.z + w * c.z);
+                        }
+                    }
+                }
+
+                std::vector<bool> isInside(_Dimensions.x * _Dimensions.y * _Dimensions.z, false);
+
+                for (int j = 0; j < _Dimensions.y; j++) {
+                    for (int i = 0; i < _Dimensions.x; i++) {
+                        auto &crossings = crossingsPerColumn[j * _Dimensions.x + i];
+
+                        std::sort(crossings.begin(), crossings.end());
+
+                        std::size_t nbCrossed = 0;
+
+                        for (int k = 0; k < _Dimensions.z; k++) {
+                            float z = _Origin.z + _CellSize * k;
+
+                            while (nbCrossed < crossings.size() && crossings[nbCrossed] < z)
+                                nbCrossed++;
+                            isInside[NodeIndex(i, j, k)] = nbCrossed % 2 == 1;
+                        }
+                    }
+                }
+
+                return isInside;
+            }
+
+            float GetNode(int i, int j, int k) const
+            {
+                int brick = _BrickIndices[BrickIndex(i / BRICK_SIZE, j / BRICK_SIZE, k / BRICK_SIZE)];
+
+                if (brick == UNIFORM_OUTSIDE)
+                    return _Band;
+                if (brick == UNIFORM_INSIDE)
+                    return -_Band;
+                return _BrickValues[brick * BRICK_NODES + (k % BRICK_SIZE) * BRICK_SIZE * BRICK_SIZE + (j % BRICK_SIZE) * BRICK_SIZE + i % BRICK_SIZE];
+            }
+
+            std::size_t BrickCount() const
+            {
+                return (std::size_t)_BrickDimensions.x * _BrickDimensions.y * _BrickDimensions.z;
+            }
+
+            std::size_t BrickIndex(int bx, int by, int bz) const
+            {
+                return ((std::size_t)bz * _BrickDimensions.y + by) * _BrickDimensions.x + bx;
+            }
+
+            glm::ivec3 BrickCoordinates(std::size_t brick) const
+            {
+                return glm::ivec3(brick % _BrickDimensions.x, (brick / _BrickDimensions.x) % _BrickDimensions.y, brick / ((std::size_t)_BrickDimensions.x * _BrickDimensions.y));
+            }
+
+            std::size_t NodeIndex(int i, int j, int k) const
+            {
+                return ((std::size_t)k * _Dimensions.y + j) * _Dimensions.x + i;
+            }
+
+            /**
+            * @brief FNV-1a of the triangles and the cell size.
+            */
+            std::uint64_t Hash(const std::vector<glm::vec3> &triangles) const
+            {
+                std::uint64_t hash = 14695981039346656037ull;
+
+                auto addBytes = [&](const void *data, std::size_t size) {
+                    for (std::size_t i = 0; i < size; i++)
+                        hash = (hash ^ ((const unsigned char *)data)[i]) * 1099511628211ull;
+                };
+
+                addBytes(triangles.data(), triangles.size() * sizeof(glm::vec3));
+                addBytes(&_CellSize, sizeof(float));
+
+                return hash;
+            }
+
+            bool Load(const std::string &path)
+            {
+                std::ifstream reader(path, std::ios::binary);
+
+                if (!reader.is_open())
+                    return false;
+                std::uint32_t magic = 0, version = 0;
+                std::uint64_t hash  = 0;
+
+                reader.read((char *)&magic, sizeof(magic));
+                reader.read((char *)&version, sizeof(version));
+                reader.read((char *)&hash, sizeof(hash));
+
+                if (!reader || magic != CACHE_MAGIC || version != CACHE_VERSION || hash != _SourceHash)
+                    return false;
+                std::uint64_t nbValues = 0;
+
+                reader.read((char *)&_Origin, sizeof(_Origin));
+                reader.read((char *)&_Band, sizeof(_Band));
+                reader.read((char *)&_BrickDimensions, sizeof(_BrickDimensions));
+                reader.read((char *)&nbValues, sizeof(nbValues));
+
+                if (!reader)
+                    return false;
+                _Dimensions = _BrickDimensions * BRICK_SIZE;
+
+                _BrickIndices.resize(BrickCount());
+                _BrickValues.resize(nbValues);
+
+                reader.read((char *)_BrickIndices.data(), _BrickIndices.size() * sizeof(int));
+                reader.read((char *)_BrickValues.data(), _BrickValues.size() * sizeof(float));
+
+                return (bool)reader;
+            }
+
+            void Save(const std::string &path) const
+            {
+                std::ofstream writer(path, std::ios::binary);
+
+                if (!writer.is_open()) {
+                    std::cerr << "Could not write the SDF cache " << path << std::endl;
+
+                    return;
+                }
+
+                std::uint64_t nbValues = _BrickValues.size();
+
+                writer.write((const char *)&CACHE_MAGIC, sizeof(CACHE_MAGIC));
+                writer.write((const char *)&CACHE_VERSION, sizeof(CACHE_VERSION));
+                writer.write((const char *)&_SourceHash, sizeof(_SourceHash));
+                writer.write((const char *)&_Origin, sizeof(_Origin));
+                writer.write((const char *)&_Band, sizeof(_Band));
+                writer.write((const char *)&_BrickDimensions, sizeof(_BrickDimensions));
+                writer.write((const char *)&nbValues, sizeof(nbValues));
+                writer.write((const char *)_BrickIndices.data(), _BrickIndices.size() * sizeof(int));
+                writer.write((const char *)_BrickValues.data(), _BrickValues.size() * sizeof(float));
+            }
+
+        private:
+
+            static constexpr int   BRICK_SIZE  = 8;
+            static constexpr int   BRICK_NODES = BRICK_SIZE * BRICK_SIZE * BRICK_SIZE;
+            static constexpr float BAND_CELLS  = 3.0f;
+
+            static constexpr int UNIFORM_OUTSIDE = -1;
+            static constexpr int UNIFORM_INSIDE  = -2;
+
+            static constexpr std::uint32_t CACHE_MAGIC   = 0x46445345; // "ESDF"
+            static constexpr std::uint32_t CACHE_VERSION = 1;
+
+            float         _CellSize;
+            float         _Band = 0.0f;
+            glm::vec3     _Origin {};
+            glm::ivec3    _Dimensions {};
+            glm::ivec3    _BrickDimensions {};
+            std::uint64_t _SourceHash = 0;
+
+            // Brick of each brick slot of the grid (or UNIFORM_*), and the values of the bricks, x fastest.
+            std::vector<int>   _BrickIndices;
+            std::vector<float> _BrickValues;
+    };
+};
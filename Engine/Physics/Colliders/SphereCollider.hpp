@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Collider.hpp"
+
+namespace Exodia {
+
+    class SphereCollider : public Collider {
+
+        public:
+
+            SphereCollider(glm::vec3 center, float radius) : _Center(center), _Radius(radius) {};
+
+        public:
+
+            float SignedDistance(glm::vec3 point, glm::vec3 &normal) const override
+            {
+                glm::vec3 offset = point - _Center;
+
+                float distance = glm::length(offset);
+
+                normal = distance > 1e-6f ? offset / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+
+                return distance - _Radius;
+            }
+
+        private:
+
+            glm::vec3 _Center;
+            float     _Radius;
+    };
+};
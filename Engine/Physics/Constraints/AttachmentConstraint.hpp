@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Compliant pin of particles of one body to targets moving together.
+    */
+    class AttachmentConstraint {
+
+        public:
+
+            AttachmentConstraint(const std::vector<int> &particleIndices, const std::vector<glm::vec3> &offsets, const std::vector<float> &compliances, glm::vec3 position) : _Indices(particleIndices), _Offsets(offsets), _Compliances(compliances), _Position(position) {};
+
+        public:
+
+            /**
+            * @brief Projects each particle toward its target as a compliant XPBD constraint.
+            */
+            void Solve(std::vector<glm::vec3> &positions, const std::vector<float> &inverseMasses, float deltaTime) const
+            {
+                float deltaTime2 = deltaTime * deltaTime;
+
+                glm::mat3 rotation = glm::mat3_cast(_Orientation);
+
+                for (std::size_t k = 0; k < _Indices.size(); k++) {
+                    int index = _Indices[k];
+
+                    float inverseMass = inverseMasses[index];
+
+                    if (inverseMass == 0.0f)
+                        continue;
+                    glm::vec3 correction = GetTarget(rotation, k) - positions[index];
+
+                    positions[index] += (inverseMass / (inverseMass + _Compliances[k] / deltaTime2)) * correction;
+                }
+            }
+
+            void SetTarget(glm::vec3 position)
+            {
+                _Position = position;
+            }
+
+            /**
+            * @brief Moves and turns the targets as a whole, rotation being about the position.
+            */
+            void SetPose(glm::vec3 position, glm::quat orientation)
+            {
+                _Position    = position;
+                _Orientation = orientation;
+            }
+
+            glm::vec3 GetTarget(const glm::mat3 &rotation, std::size_t k) const
+            {
+                return _Position + rotation * _Offsets[k];
+            }
+
+            glm::quat GetOrientation() const
+            {
+                return _Orientation;
+            }
+
+            const std::vector<int> &GetParticleIndices() const
+            {
+                return _Indices;
+            }
+
+            void RemapParticles(const std::vector<int> &newIndices)
+            {
+                for (int& index : _Indices)
+                    index = newIndices[index];
+            }
+
+            const std::vector<float> &GetCompliances() const
+            {
+                return _Compliances;
+            }
+
+        private:
+
+            std::vector<int>       _Indices;
+            std::vector<glm::vec3> _Offsets;
+            std::vector<float>     _Compliances;
+
+            glm::vec3 _Position;
+            glm::quat _Orientation { 1.0f, 0.0f, 0.0f, 0.0f };
+    };
+};
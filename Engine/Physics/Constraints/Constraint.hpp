@@ -42,12 +42,13 @@ namespace Exodia {
 
             void Solve(float deltaTime)
             {
-                if (IsSatisfied())
+                float constraintValue = Evaluate();
+
+                if (IsSatisfied(constraintValue))
                     return;
                 ComputeGradient();
 
                 float xpbdFactor      = _Compliance / (deltaTime * deltaTime);
-                float constraintValue = Evaluate();
                 float numerator       = -constraintValue - xpbdFactor * _Lambda;
                 float denominator     = xpbdFactor;
 
@@ -88,6 +89,11 @@ namespace Exodia {
                 return _Particles;
             }
 
+            const std::shared_ptr<Particle>& GetParticle(std::size_t index) const
+            {
+                return _Particles[index];
+            }
+
             void SetParticles(std::vector<std::shared_ptr<Particle>> particles)
             {
                 _Particles = std::move(particles);
@@ -106,12 +112,17 @@ namespace Exodia {
         protected:
 
             bool IsSatisfied() const
+            {
+                return IsSatisfied(Evaluate());
+            }
+
+            bool IsSatisfied(float constraintValue) const
             {
                 switch (_Type) {
                     case INEQUALITY:
-                        return Evaluate() >= 0;
+                        return constraintValue >= 0;
                     case EQUALITY:
-                        return fabsf(Evaluate()) <= 1e-6;
+                        return fabsf(constraintValue) <= 1e-6;
                 }
 
                 throw std::runtime_error("Constraint type not handled");
@@ -0,0 +1,311 @@
+#pragma once
+
+#include "Constraint.hpp"
+#include "Utils/ThreadPool.hpp"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Exodia {
+
+    /**
+    * @brief Packed and colored constraints of one type, solved without virtual calls.
+    */
+    template<typename Kernel>
+    struct ConstraintBatch {
+
+        static constexpr unsigned int Arity = Kernel::Arity;
+
+        using RestValue = typename Kernel::RestValue;
+
+        struct Layout {
+            std::vector<std::array<int, Arity>> Indices      {};
+            std::vector<RestValue>              RestValues   {};
+            std::vector<float>                  Compliances  {};
+            std::vector<std::size_t>            ColorOffsets {};
+        };
+
+        std::vector<float> Lambdas {};
+
+        const std::vector<std::array<int, Arity>> &Indices() const
+        {
+            return _Layout->Indices;
+        }
+
+        const std::vector<RestValue> &RestValues() const
+        {
+            return _Layout->RestValues;
+        }
+
+        const std::vector<float> &Compliances() const
+        {
+            return _Layout->Compliances;
+        }
+
+        const std::vector<std::size_t> &ColorOffsets() const
+        {
+            return _Layout->ColorOffsets;
+        }
+
+        /**
+        * @brief Replaces the constraints, their multipliers reset.
+        */
+        void SetLayout(Layout layout)
+        {
+            _Layout = std::make_shared<Layout>(std::move(layout));
+
+            Lambdas.assign(Size(), 0.0f);
+        }
+
+        void Add(const std::array<int, Arity> &indices, const RestValue &restValue, float compliance)
+        {
+            Layout &layout = Edit();
+
+            layout.Indices.push_back(indices);
+            layout.RestValues.push_back(restValue);
+            layout.Compliances.push_back(compliance);
+            layout.ColorOffsets.clear();
+
+            Lambdas.push_back(0.0f);
+        }
+
+        /**
+        * @brief Moves constraint c to other particles, which must keep it apart from the rest of its color.
+        */
+        void SetIndices(std::size_t c, const std::array<int, Arity> &indices)
+        {
+            Edit().Indices[c] = indices;
+        }
+
+        void ResetLambdas()
+        {
+            Lambdas.assign(Size(), 0.0f);
+        }
+
+        void Clear()
+        {
+            _Layout = std::make_shared<Layout>();
+
+            Lambdas.clear();
+        }
+
+        std::size_t Size() const
+        {
+            return _Layout->Indices.size();
+        }
+
+        /**
+        * @brief Projects the constraints of [begin, end) in order, same update as Constraint::Solve.
+        */
+        void Solve(std::vector<glm::vec3> &positions, const std::vector<float> &inverseMasses, float deltaTime, std::size_t begin, std::size_t end)
+        {
+            const Layout &layout = *_Layout;
+
+            float deltaTime2 = deltaTime * deltaTime;
+
+            for (std::size_t c = begin; c < end; c++) {
+                const auto &indices = layout.Indices[c];
+
+                std::array<glm::vec3, Arity> p;
+                std::array<glm::vec3, Arity> gradient;
+
+                for (unsigned int i = 0; i < Arity; i++)
+                    p[i] = positions[indices[i]];
+                float constraintValue = 0.0f;
+                bool  hasGradient     = Kernel::Evaluate(p, layout.RestValues[c], constraintValue, gradient);
+
+                if (IsSatisfied(constraintValue) || !hasGradient)
+                    continue;
+                float xpbdFactor  = layout.Compliances[c] / deltaTime2;
+                float numerator   = -constraintValue - xpbdFactor * Lambdas[c];
+                float denominator = xpbdFactor;
+
+                for (unsigned int i = 0; i < Arity; i++)
+                    denominator += inverseMasses[indices[i]] * glm::dot(gradient[i], gradient[i]);
+                if (denominator < 1e-6f)
+                    continue;
+                float deltaLambda = numerator / denominator;
+
+                if (std::isnan(deltaLambda))
+                    deltaLambda = 0.0f;
+                for (unsigned int i = 0; i < Arity; i++)
+                    positions[indices[i]] += (-constraintValue / denominator) * inverseMasses[indices[i]] * gradient[i];
+                Lambdas[c] += deltaLambda;
+            }
+        }
+
+        void Solve(std::vector<glm::vec3> &positions, const std::vector<float> &inverseMasses, float deltaTime)
+        {
+            const Layout &layout = *_Layout;
+
+            if (layout.ColorOffsets.empty()) {
+                Solve(positions, inverseMasses, deltaTime, 0, Size());
+
+                return;
+            }
+
+            // A color touches each particle at most once.
+            for (std::size_t color = 0; color + 1 < layout.ColorOffsets.size(); color++) {
+                std::size_t offset = layout.ColorOffsets[color];
+
+                ThreadPool::Get().ParallelFor(layout.ColorOffsets[color + 1] - offset, COLOR_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    begin += offset;
+                    end   += offset;
+
+                    if constexpr (requires { &Kernel::SolveColor; })
+                        begin += Kernel::SolveColor(&layout.Indices[begin], &layout.RestValues[begin], &layout.Compliances[begin], &Lambdas[begin], end - begin, positions.data(), inverseMasses.data(), deltaTime);
+                    Solve(positions, inverseMasses, deltaTime, begin, end);
+                });
+            }
+        }
+
+        /**
+        * @brief Greedy coloring then stable sort by color; returns the order of the sort.
+        */
+        std::vector<std::size_t> Color(std::size_t nbParticles)
+        {
+            Layout &layout = Edit();
+
+            std::vector<std::vector<unsigned int>> colorsPerParticle(nbParticles);
+            std::vector<unsigned int>              constraintColors(Size());
+            std::vector<std::size_t>               nbConstraintsPerColor;
+            std::vector<bool>                      isColorUsed;
+
+            for (std::size_t c = 0; c < Size(); c++) {
+                isColorUsed.assign(nbConstraintsPerColor.size() + 1, false);
+
+                for (unsigned int i = 0; i < Arity; i++)
+                    for (unsigned int color : colorsPerParticle[layout.Indices[c][i]])
+                        isColorUsed[color] = true;
+                unsigned int color = 0;
+
+                while (isColorUsed[color])
+                    color++;
+                if (color == nbConstraintsPerColor.size())
+                    nbConstraintsPerColor.push_back(0);
+                nbConstraintsPerColor[color]++;
+                constraintColors[c] = color;
+
+                for (unsigned int i = 0; i < Arity; i++)
+                    colorsPerParticle[layout.Indices[c][i]].push_back(color);
+            }
+
+            layout.ColorOffsets.assign(nbConstraintsPerColor.size() + 1, 0);
+
+            for (std::size_t color = 0; color < nbConstraintsPerColor.size(); color++)
+                layout.ColorOffsets[color + 1] = layout.ColorOffsets[color] + nbConstraintsPerColor[color];
+            std::vector<std::size_t> order(Size());
+            std::vector<std::size_t> cursor(layout.ColorOffsets.begin(), layout.ColorOffsets.end() - 1);
+
+            for (std::size_t c = 0; c < Size(); c++)
+                order[cursor[constraintColors[c]]++] = c;
+            Permute(layout.Indices, order);
+            Permute(layout.RestValues, order);
+            Permute(layout.Compliances, order);
+            Permute(Lambdas, order);
+
+            return order;
+        }
+
+        /**
+        * @brief Adds a constraint to a colored batch, in its last color if it shares no particle with it, else in a new one.
+        */
+        void AddColored(const std::array<int, Arity> &indices, const RestValue &restValue, float compliance)
+        {
+            if (ColorOffsets().size() < 2) {
+                Add(indices, restValue, compliance);
+
+                return;
+            }
+            Layout &layout = Edit();
+
+            bool isShared = false;
+
+            for (std::size_t c = layout.ColorOffsets[layout.ColorOffsets.size() - 2]; c < Size() && !isShared; c++)
+                for (unsigned int i = 0; i < Arity; i++)
+                    for (unsigned int j = 0; j < Arity; j++)
+                        isShared |= layout.Indices[c][i] == indices[j];
+            layout.Indices.push_back(indices);
+            layout.RestValues.push_back(restValue);
+            layout.Compliances.push_back(compliance);
+
+            Lambdas.push_back(0.0f);
+
+            if (isShared)
+                layout.ColorOffsets.push_back(Size());
+            else
+                layout.ColorOffsets.back() = Size();
+        }
+
+        /**
+        * @brief Remaps the particles of each constraint in place, false removing it.
+        */
+        template<typename Function>
+        void Remap(Function remap)
+        {
+            Layout &layout = Edit();
+
+            std::vector<std::size_t> offsets = layout.ColorOffsets;
+
+            std::size_t size  = 0;
+            std::size_t color = 0;
+
+            for (std::size_t c = 0; c < Size(); c++) {
+                while (color + 1 < offsets.size() && offsets[color + 1] <= c)
+                    layout.ColorOffsets[++color] = size;
+                if (!remap(layout.Indices[c]))
+                    continue;
+                layout.Indices[size]     = layout.Indices[c];
+                layout.RestValues[size]  = layout.RestValues[c];
+                layout.Compliances[size] = layout.Compliances[c];
+                Lambdas[size]            = Lambdas[c];
+
+                size++;
+            }
+
+            for (color++; color < offsets.size(); color++)
+                layout.ColorOffsets[color] = size;
+            layout.Indices.resize(size);
+            layout.RestValues.resize(size);
+            layout.Compliances.resize(size);
+            Lambdas.resize(size);
+        }
+
+        template<typename T>
+        static void Permute(std::vector<T> &values, const std::vector<std::size_t> &order)
+        {
+            std::vector<T> permuted(values.size());
+
+            for (std::size_t k = 0; k < order.size(); k++)
+                permuted[k] = values[order[k]];
+            values = std::move(permuted);
+        }
+
+        static bool IsSatisfied(float constraintValue)
+        {
+            if constexpr (Kernel::Type == INEQUALITY)
+                return constraintValue >= 0;
+            else
+                return fabsf(constraintValue) <= 1e-6;
+        }
+
+        static constexpr std::size_t COLOR_GRAIN_SIZE = 2048;
+
+        private:
+
+            /**
+            * @brief The layout of this batch alone, copied first when another batch shares it.
+            */
+            Layout &Edit()
+            {
+                if (_Layout.use_count() > 1)
+                    _Layout = std::make_shared<Layout>(*_Layout);
+                return *_Layout;
+            }
+
+            std::shared_ptr<Layout> _Layout = std::make_shared<Layout>();
+    };
+};
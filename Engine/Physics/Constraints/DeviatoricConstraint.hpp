@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Constraint.hpp"
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cmath>
+
+namespace Exodia {
+
+    /**
+    * @brief Fused evaluation of a tetrahedron deviatoric constraint, |F| - sqrt(3), for ConstraintBatch.
+    */
+    struct DeviatoricKernel {
+
+        static constexpr unsigned int   Arity = 4;
+        static constexpr ConstraintType Type  = EQUALITY;
+
+        using RestValue = glm::mat3;  // Inverse of the rest edge matrix.
+
+        /**
+        * @brief Inverse of the edge matrix of the rest tetrahedron, null when it is flat.
+        */
+        static glm::mat3 ComputeRestValue(const std::array<glm::vec3, 4> &p)
+        {
+            glm::mat3 restMatrix(p[1] - p[0], p[2] - p[0], p[3] - p[0]);
+
+            if (glm::determinant(restMatrix) == 0.0f)
+                return glm::mat3(0.0f);
+            return glm::inverse(restMatrix);
+        }
+
+        static bool Evaluate(const std::array<glm::vec3, 4> &p, const glm::mat3 &inverseRestMatrix, float &value, std::array<glm::vec3, 4> &gradient)
+        {
+            glm::mat3 F = glm::mat3(p[1] - p[0], p[2] - p[0], p[3] - p[0]) * inverseRestMatrix;
+
+            float norm = sqrtf(glm::dot(F[0], F[0]) + glm::dot(F[1], F[1]) + glm::dot(F[2], F[2]));
+
+            value = norm - sqrtf(3.0f);
+
+            if (norm < 1e-6f)
+                return false;
+
+            // dC/dF = F / |F|, and dC/d[p1 - p0, p2 - p0, p3 - p0] = dC/dF * InverseRestMatrix^T.
+            glm::mat3 edgeGradient = (F / norm) * glm::transpose(inverseRestMatrix);
+
+            gradient[1] = edgeGradient[0];
+            gradient[2] = edgeGradient[1];
+            gradient[3] = edgeGradient[2];
+            gradient[0] = -gradient[1] - gradient[2] - gradient[3];
+
+            return true;
+        }
+    };
+
+    class DeviatoricConstraint : public Constraint {
+
+        public:
+
+            DeviatoricConstraint(std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, std::shared_ptr<Particle> p3, std::shared_ptr<Particle> p4, float compliance) : Constraint({ p1, p2, p3, p4 }, compliance, EQUALITY)
+            {
+                _InverseRestMatrix = DeviatoricKernel::ComputeRestValue(Positions(&Particle::Position));
+            };
+
+            DeviatoricConstraint(std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, std::shared_ptr<Particle> p3, std::shared_ptr<Particle> p4, float compliance, const glm::mat3 &inverseRestMatrix) : Constraint({ p1, p2, p3, p4 }, compliance, EQUALITY), _InverseRestMatrix(inverseRestMatrix) {};
+
+        public:
+
+            float Evaluate() const override
+            {
+                float value = 0.0f;
+                std::array<glm::vec3, 4> gradient;
+
+                DeviatoricKernel::Evaluate(Positions(&Particle::PredictedPosition), _InverseRestMatrix, value, gradient);
+
+                return value;
+            }
+
+            const glm::mat3 &GetRestValue() const
+            {
+                return _InverseRestMatrix;
+            }
+
+        private:
+
+            void ComputeGradient() override
+            {
+                float value = 0.0f;
+                std::array<glm::vec3, 4> gradient {};
+
+                if (!DeviatoricKernel::Evaluate(Positions(&Particle::PredictedPosition), _InverseRestMatrix, value, gradient))
+                    gradient = {};
+                for (unsigned int i = 0; i < 4; i++)
+                    _Gradient[i] = gradient[i];
+            }
+
+            void RecomputeTargetValue() override
+            {
+                _InverseRestMatrix = DeviatoricKernel::ComputeRestValue(Positions(&Particle::Position));
+            }
+
+            std::array<glm::vec3, 4> Positions(glm::vec3 Particle::*position) const
+            {
+                return { (*_Particles[0]).*position, (*_Particles[1]).*position, (*_Particles[2]).*position, (*_Particles[3]).*position };
+            }
+
+        private:
+
+            glm::mat3 _InverseRestMatrix;
+    };
+};
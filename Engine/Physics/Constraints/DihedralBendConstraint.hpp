@@ -1,13 +1,77 @@
 #pragma once
 
 #include "Constraint.hpp"
+#include "DihedralBendKernelSimd.hpp"
+#include "Settings.hpp"
 #include "Utils/Utils.hpp"
 
 #include <glm/geometric.hpp>
+#include <array>
 #include <iostream>
 
 namespace Exodia {
 
+    /**
+    * @brief Fused evaluation of a dihedral bend constraint for ConstraintBatch.
+    */
+    struct DihedralBendKernel {
+
+        static constexpr unsigned int   Arity = 4;
+        static constexpr ConstraintType Type  = EQUALITY;
+
+        using RestValue = float;
+
+        static bool Evaluate(const std::array<glm::vec3, 4> &p, float restAngle, float &value, std::array<glm::vec3, 4> &gradient)
+        {
+            glm::vec3 em = p[1] - p[0];
+            glm::vec3 el = p[2] - p[0];
+            glm::vec3 er = p[3] - p[0];
+
+            glm::vec3 n1 = glm::cross(em, el);
+            glm::vec3 n2 = glm::cross(em, er);
+
+            float l1 = glm::length(n1);
+            float l2 = glm::length(n2);
+
+            value = 0.0f;
+
+            if (l1 == 0.0f || l2 == 0.0f)
+                return false;
+            n1 /= l1;
+            n2 /= l2;
+
+            float cosPhi = glm::clamp(glm::dot(n1, n2), -1.0f, 1.0f);
+            float phi    = Settings::DIHEDRAL_ANGLE_PRECISION == ANGLE_PRECISION_FAST ? DihedralBendKernelSimd::FastAcos(cosPhi) : acosf(cosPhi);
+            bool  isReflex = glm::dot(glm::cross(n1, n2), em) < 0.0f;
+
+            value = (isReflex ? 2.0f * glm::pi<float>() - phi : phi) - restAngle;
+
+            float cosPhi2 = cosPhi * cosPhi;
+
+            if (cosPhi2 == 1.0f)
+                return false;
+            float arcosDerivative = -1.0f / sqrtf(1.0f - cosPhi2);
+
+            if (isReflex)
+                arcosDerivative = -arcosDerivative;
+            glm::vec3 dp1 = (glm::cross(er, n1) + cosPhi * glm::cross(n2, er)) / l2 + (glm::cross(el, n2) + cosPhi * glm::cross(n1, el)) / l1;
+            glm::vec3 dp2 = (glm::cross(n2, em) - cosPhi * glm::cross(n1, em)) / l1;
+            glm::vec3 dp3 = (glm::cross(n1, em) - cosPhi * glm::cross(n2, em)) / l2;
+
+            gradient[1] = arcosDerivative * dp1;
+            gradient[2] = arcosDerivative * dp2;
+            gradient[3] = arcosDerivative * dp3;
+            gradient[0] = -gradient[1] - gradient[2] - gradient[3];
+
+            return true;
+        }
+
+        static std::size_t SolveColor(const std::array<int, 4> *indices, const float *restAngles, const float *compliances, float *lambdas, std::size_t count, glm::vec3 *positions, const float *inverseMasses, float deltaTime)
+        {
+            return DihedralBendKernelSimd::SolveColor(indices, restAngles, compliances, lambdas, count, positions, inverseMasses, deltaTime, Settings::DIHEDRAL_ANGLE_PRECISION);
+        }
+    };
+
     class DihedralBendConstraint : public Constraint {
 
         public:
@@ -31,6 +95,8 @@ namespace Exodia {
                 _Phi = acosf(dot);
             };
 
+            DihedralBendConstraint(std::shared_ptr<Particle> p0, std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, std::shared_ptr<Particle> p3, float compliance, float restAngle) : Constraint({ p0, p1, p2, p3 }, compliance, EQUALITY), _Phi(restAngle) {};
+
             float Evaluate() const override
             {
                 glm::vec3 p0 = _Particles[0]->PredictedPosition;
@@ -56,6 +122,11 @@ namespace Exodia {
                 return phi - _Phi;
             }
 
+            float GetRestAngle() const
+            {
+                return _Phi;
+            }
+
         private:
 
             void ComputeGradient() override
@@ -0,0 +1,425 @@
+#pragma once
+
+#include "Settings.hpp"
+#include "Utils/Simd.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+namespace Exodia {
+
+    /**
+    * @brief Vectorized dihedral bend projection, bitwise identical to DihedralBendKernel.
+    */
+    class DihedralBendKernelSimd {
+
+        public:
+
+            /**
+            * @brief Polynomial arc cosine, absolute error around 4e-7 on [-1, 1].
+            */
+            static float FastAcos(float x)
+            {
+                float ax = fabsf(x);
+                float polynomial = ACOS_COEFFICIENTS[7];
+
+                for (int k = 6; k >= 0; k--)
+                    polynomial = polynomial * ax + ACOS_COEFFICIENTS[k];
+                float result = sqrtf(1.0f - ax) * polynomial;
+
+                return x < 0.0f ? glm::pi<float>() - result : result;
+            }
+
+            /**
+            * @brief Solves the largest multiple of the vector width of [0, count) and returns how many constraints it solved.
+            */
+            static std::size_t SolveColor(const std::array<int, 4> *indices, const float *restAngles, const float *compliances, float *lambdas, std::size_t count, glm::vec3 *positions, const float *inverseMasses, float deltaTime, AnglePrecision precision)
+            {
+                static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Positions are gathered as packed floats.");
+                static_assert(sizeof(std::array<int, 4>) == 4 * sizeof(int), "Indices are loaded as packed quadruplets.");
+
+#if defined(EXODIA_SIMD_X86)
+                switch (Simd::GetLevel()) {
+                    case SIMD_AVX2:
+                        return SolveColorAVX2(indices, restAngles, compliances, lambdas, count, &positions[0].x, inverseMasses, deltaTime, precision);
+                    case SIMD_SSE:
+                        return SolveColorSSE(indices, restAngles, compliances, lambdas, count, &positions[0].x, inverseMasses, deltaTime, precision);
+                    default:
+                        break;
+                }
+#endif
+                return 0;
+            }
+
+        private:
+
+            static constexpr float ACOS_COEFFICIENTS[8] = {
+                1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f, 0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f
+            };
+
+#if defined(EXODIA_SIMD_X86)
+            struct Vec3SSE {
+                __m128 x, y, z;
+            };
+
+            struct Vec3AVX2 {
+                __m256 x, y, z;
+            };
+
+            static __m128 Select(__m128 mask, __m128 a, __m128 b)
+            {
+                return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+            }
+
+            static Vec3SSE Sub(const Vec3SSE &a, const Vec3SSE &b)
+            {
+                return { _mm_sub_ps(a.x, b.x), _mm_sub_ps(a.y, b.y), _mm_sub_ps(a.z, b.z) };
+            }
+
+            static Vec3SSE Add(const Vec3SSE &a, const Vec3SSE &b)
+            {
+                return { _mm_add_ps(a.x, b.x), _mm_add_ps(a.y, b.y), _mm_add_ps(a.z, b.z) };
+            }
+
+            static Vec3SSE Scale(__m128 s, const Vec3SSE &a)
+            {
+                return { _mm_mul_ps(s, a.x), _mm_mul_ps(s, a.y), _mm_mul_ps(s, a.z) };
+            }
+
+            static Vec3SSE Div(const Vec3SSE &a, __m128 s)
+            {
+                return { _mm_div_ps(a.x, s), _mm_div_ps(a.y, s), _mm_div_ps(a.z, s) };
+            }
+
+            static Vec3SSE Cross(const Vec3SSE &a, const Vec3SSE &b)
+            {
+                return {
+                    _mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(b.y, a.z)),
+                    _mm_sub_ps(_mm_mul_ps(a.z, b.x), _mm_mul_ps(b.z, a.x)),
+                    _mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(b.x, a.y))
+                };
+            }
+
+            static __m128 Dot(const Vec3SSE &a, const Vec3SSE &b)
+            {
+                return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)), _mm_mul_ps(a.z, b.z));
+            }
+
+            static __m128 Acos(__m128 x, AnglePrecision precision)
+            {
+                if (precision == ANGLE_PRECISION_EXACT) {
+                    alignas(16) float lanes[4];
+
+                    _mm_store_ps(lanes, x);
+
+                    for (int k = 0; k < 4; k++)
+                        lanes[k] = acosf(lanes[k]);
+                    return _mm_load_ps(lanes);
+                }
+
+                __m128 ax         = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+                __m128 polynomial = _mm_set1_ps(ACOS_COEFFICIENTS[7]);
+
+                for (int k = 6; k >= 0; k--)
+                    polynomial = _mm_add_ps(_mm_mul_ps(polynomial, ax), _mm_set1_ps(ACOS_COEFFICIENTS[k]));
+                __m128 result = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), ax)), polynomial);
+
+                return Select(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(glm::pi<float>()), result), result);
+            }
+
+            static std::size_t SolveColorSSE(const std::array<int, 4> *indices, const float *restAngles, const float *compliances, float *lambdas, std::size_t count, float *positions, const float *inverseMasses, float deltaTime, AnglePrecision precision)
+            {
+                const __m128 deltaTime2 = _mm_set1_ps(deltaTime * deltaTime);
+                const __m128 epsilon    = _mm_set1_ps(1e-6f);
+                const __m128 signMask   = _mm_set1_ps(-0.0f);
+                const __m128 zero       = _mm_setzero_ps();
+                const __m128 one        = _mm_set1_ps(1.0f);
+
+                std::size_t c = 0;
+
+                for (; c + 4 <= count; c += 4) {
+                    alignas(16) float lanes[4][3][4];
+                    alignas(16) float masses[4][4];
+
+                    for (int k = 0; k < 4; k++) {
+                        for (int i = 0; i < 4; i++) {
+                            const float *p = positions + 3 * indices[c + k][i];
+
+                            lanes[i][0][k] = p[0]; lanes[i][1][k] = p[1]; lanes[i][2][k] = p[2];
+
+                            masses[i][k] = inverseMasses[indices[c + k][i]];
+                        }
+                    }
+
+                    Vec3SSE p[4];
+                    __m128  w[4];
+
+                    for (int i = 0; i < 4; i++) {
+                        p[i] = { _mm_load_ps(lanes[i][0]), _mm_load_ps(lanes[i][1]), _mm_load_ps(lanes[i][2]) };
+                        w[i] = _mm_load_ps(masses[i]);
+                    }
+
+                    Vec3SSE em = Sub(p[1], p[0]);
+                    Vec3SSE el = Sub(p[2], p[0]);
+                    Vec3SSE er = Sub(p[3], p[0]);
+
+                    Vec3SSE n1 = Cross(em, el);
+                    Vec3SSE n2 = Cross(em, er);
+
+                    __m128 l1 = _mm_sqrt_ps(Dot(n1, n1));
+                    __m128 l2 = _mm_sqrt_ps(Dot(n2, n2));
+
+                    __m128 hasGradient = _mm_and_ps(_mm_cmpneq_ps(l1, zero), _mm_cmpneq_ps(l2, zero));
+
+                    n1 = Div(n1, l1);
+                    n2 = Div(n2, l2);
+
+                    __m128 cosPhi   = _mm_min_ps(one, _mm_max_ps(_mm_set1_ps(-1.0f), Dot(n1, n2)));
+                    __m128 phi      = Acos(cosPhi, precision);
+                    __m128 isReflex = _mm_cmplt_ps(Dot(Cross(n1, n2), em), zero);
+
+                    __m128 value = _mm_sub_ps(Select(isReflex, _mm_sub_ps(_mm_set1_ps(2.0f * glm::pi<float>()), phi), phi), _mm_loadu_ps(restAngles + c));
+
+                    __m128 cosPhi2 = _mm_mul_ps(cosPhi, cosPhi);
+
+                    hasGradient = _mm_and_ps(hasGradient, _mm_cmpneq_ps(cosPhi2, one));
+
+                    __m128 arcosDerivative = _mm_div_ps(_mm_set1_ps(-1.0f), _mm_sqrt_ps(_mm_sub_ps(one, cosPhi2)));
+
+                    arcosDerivative = _mm_xor_ps(arcosDerivative, _mm_and_ps(isReflex, signMask));
+
+                    Vec3SSE dp1 = Add(Div(Add(Cross(er, n1), Scale(cosPhi, Cross(n2, er))), l2), Div(Add(Cross(el, n2), Scale(cosPhi, Cross(n1, el))), l1));
+                    Vec3SSE dp2 = Div(Sub(Cross(n2, em), Scale(cosPhi, Cross(n1, em))), l1);
+                    Vec3SSE dp3 = Div(Sub(Cross(n1, em), Scale(cosPhi, Cross(n2, em))), l2);
+
+                    Vec3SSE gradient[4];
+
+                    gradient[1] = Scale(arcosDerivative, dp1);
+                    gradient[2] = Scale(arcosDerivative, dp2);
+                    gradient[3] = Scale(arcosDerivative, dp3);
+
+                    Vec3SSE negated = { _mm_xor_ps(gradient[1].x, signMask), _mm_xor_ps(gradient[1].y, signMask), _mm_xor_ps(gradient[1].z, signMask) };
+
+                    gradient[0] = Sub(Sub(negated, gradient[2]), gradient[3]);
+
+                    __m128 xpbdFactor  = _mm_div_ps(_mm_loadu_ps(compliances + c), deltaTime2);
+                    __m128 denominator = xpbdFactor;
+
+                    for (int i = 0; i < 4; i++)
+                        denominator = _mm_add_ps(denominator, _mm_mul_ps(w[i], Dot(gradient[i], gradient[i])));
+                    __m128 satisfied = _mm_cmple_ps(_mm_andnot_ps(signMask, value), epsilon);
+                    __m128 active    = _mm_andnot_ps(satisfied, _mm_and_ps(hasGradient, _mm_cmpnlt_ps(denominator, epsilon)));
+
+                    __m128 lambda      = _mm_loadu_ps(lambdas + c);
+                    __m128 negValue    = _mm_xor_ps(value, signMask);
+                    __m128 numerator   = _mm_sub_ps(negValue, _mm_mul_ps(xpbdFactor, lambda));
+                    __m128 deltaLambda = _mm_div_ps(numerator, denominator);
+
+                    deltaLambda = _mm_and_ps(_mm_cmpord_ps(deltaLambda, deltaLambda), deltaLambda);
+
+                    _mm_storeu_ps(lambdas + c, Select(active, _mm_add_ps(lambda, deltaLambda), lambda));
+
+                    __m128 scale = _mm_div_ps(negValue, denominator);
+
+                    for (int i = 0; i < 4; i++) {
+                        Vec3SSE moved = Add(p[i], Scale(_mm_mul_ps(scale, w[i]), gradient[i]));
+
+                        _mm_store_ps(lanes[i][0], Select(active, moved.x, p[i].x));
+                        _mm_store_ps(lanes[i][1], Select(active, moved.y, p[i].y));
+                        _mm_store_ps(lanes[i][2], Select(active, moved.z, p[i].z));
+                    }
+
+                    for (int k = 0; k < 4; k++) {
+                        for (int i = 0; i < 4; i++) {
+                            float *position = positions + 3 * indices[c + k][i];
+
+                            position[0] = lanes[i][0][k]; position[1] = lanes[i][1][k]; position[2] = lanes[i][2][k];
+                        }
+                    }
+                }
+
+                return c;
+            }
+
+            EXODIA_TARGET_AVX2 static __m256 Select(__m256 mask, __m256 a, __m256 b)
+            {
+                return _mm256_blendv_ps(b, a, mask);
+            }
+
+            EXODIA_TARGET_AVX2 static Vec3AVX2 Sub(const Vec3AVX2 &a, const Vec3AVX2 &b)
+            {
+                return { _mm256_sub_ps(a.x, b.x), _mm256_sub_ps(a.y, b.y), _mm256_sub_ps(a.z, b.z) };
+            }
+
+            EXODIA_TARGET_AVX2 static Vec3AVX2 Add(const Vec3AVX2 &a, const Vec3AVX2 &b)
+            {
+                return { _mm256_add_ps(a.x, b.x), _mm256_add_ps(a.y, b.y), _mm256_add_ps(a.z, b.z) };
+            }
+
+            EXODIA_TARGET_AVX2 static Vec3AVX2 Scale(__m256 s, const Vec3AVX2 &a)
+            {
+                return { _mm256_mul_ps(s, a.x), _mm256_mul_ps(s, a.y), _mm256_mul_ps(s, a.z) };
+            }
+
+            EXODIA_TARGET_AVX2 static Vec3AVX2 Div(const Vec3AVX2 &a, __m256 s)
+            {
+                return { _mm256_div_ps(a.x, s), _mm256_div_ps(a.y, s), _mm256_div_ps(a.z, s) };
+            }
+
+            EXODIA_TARGET_AVX2 static Vec3AVX2 Cross(const Vec3AVX2 &a, const Vec3AVX2 &b)
+            {
+                return {
+                    _mm256_sub_ps(_mm256_mul_ps(a.y, b.z), _mm256_mul_ps(b.y, a.z)),
+                    _mm256_sub_ps(_mm256_mul_ps(a.z, b.x), _mm256_mul_ps(b.z, a.x)),
+                    _mm256_sub_ps(_mm256_mul_ps(a.x, b.y), _mm256_mul_ps(b.x, a.y))
+                };
+            }
+
+            EXODIA_TARGET_AVX2 static __m256 Dot(const Vec3AVX2 &a, const Vec3AVX2 &b)
+            {
+                return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a.x, b.x), _mm256_mul_ps(a.y, b.y)), _mm256_mul_ps(a.z, b.z));
+            }
+
+            EXODIA_TARGET_AVX2 static __m256 Acos(__m256 x, AnglePrecision precision)
+            {
+                if (precision == ANGLE_PRECISION_EXACT) {
+                    alignas(32) float lanes[8];
+
+                    _mm256_store_ps(lanes, x);
+
+                    for (int k = 0; k < 8; k++)
+                        lanes[k] = acosf(lanes[k]);
+                    return _mm256_load_ps(lanes);
+                }
+
+                __m256 ax         = _mm256_andnot_ps(_mm256_set1_ps(-0.0f), x);
+                __m256 polynomial = _mm256_set1_ps(ACOS_COEFFICIENTS[7]);
+
+                for (int k = 6; k >= 0; k--)
+                    polynomial = _mm256_add_ps(_mm256_mul_ps(polynomial, ax), _mm256_set1_ps(ACOS_COEFFICIENTS[k]));
+                __m256 result = _mm256_mul_ps(_mm256_sqrt_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), ax)), polynomial);
+
+                return Select(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ), _mm256_sub_ps(_mm256_set1_ps(glm::pi<float>()), result), result);
+            }
+
+            EXODIA_TARGET_AVX2 static std::size_t SolveColorAVX2(const std::array<int, 4> *indices, const float *restAngles, const float *compliances, float *lambdas, std::size_t count, float *positions, const float *inverseMasses, float deltaTime, AnglePrecision precision)
+            {
+                const __m256 deltaTime2 = _mm256_set1_ps(deltaTime * deltaTime);
+                const __m256 epsilon    = _mm256_set1_ps(1e-6f);
+                const __m256 signMask   = _mm256_set1_ps(-0.0f);
+                const __m256 zero       = _mm256_setzero_ps();
+                const __m256 one        = _mm256_set1_ps(1.0f);
+
+                // Index i of constraints c to c + 7 is read with a stride of 4 ints.
+                const __m256i stride = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+                const __m256i three  = _mm256_set1_epi32(3);
+
+                std::size_t c = 0;
+
+                for (; c + 8 <= count; c += 8) {
+                    const int *quadruplets = indices[c].data();
+
+                    __m256i  offsets[4];
+                    Vec3AVX2 p[4];
+                    __m256   w[4];
+
+                    for (int i = 0; i < 4; i++) {
+                        __m256i index = _mm256_i32gather_epi32(quadruplets + i, stride, 4);
+
+                        offsets[i] = _mm256_mullo_epi32(index, three);
+
+                        p[i] = {
+                            _mm256_i32gather_ps(positions    , offsets[i], 4),
+                            _mm256_i32gather_ps(positions + 1, offsets[i], 4),
+                            _mm256_i32gather_ps(positions + 2, offsets[i], 4)
+                        };
+                        w[i] = _mm256_i32gather_ps(inverseMasses, index, 4);
+                    }
+
+                    Vec3AVX2 em = Sub(p[1], p[0]);
+                    Vec3AVX2 el = Sub(p[2], p[0]);
+                    Vec3AVX2 er = Sub(p[3], p[0]);
+
+                    Vec3AVX2 n1 = Cross(em, el);
+                    Vec3AVX2 n2 = Cross(em, er);
+
+                    __m256 l1 = _mm256_sqrt_ps(Dot(n1, n1));
+                    __m256 l2 = _mm256_sqrt_ps(Dot(n2, n2));
+
+                    __m256 hasGradient = _mm256_and_ps(_mm256_cmp_ps(l1, zero, _CMP_NEQ_UQ), _mm256_cmp_ps(l2, zero, _CMP_NEQ_UQ));
+
+                    n1 = Div(n1, l1);
+                    n2 = Div(n2, l2);
+
+                    __m256 cosPhi   = _mm256_min_ps(one, _mm256_max_ps(_mm256_set1_ps(-1.0f), Dot(n1, n2)));
+                    __m256 phi      = Acos(cosPhi, precision);
+                    __m256 isReflex = _mm256_cmp_ps(Dot(Cross(n1, n2), em), zero, _CMP_LT_OQ);
+
+                    __m256 value = _mm256_sub_ps(Select(isReflex, _mm256_sub_ps(_mm256_set1_ps(2.0f * glm::pi<float>()), phi), phi), _mm256_loadu_ps(restAngles + c));
+
+                    __m256 cosPhi2 = _mm256_mul_ps(cosPhi, cosPhi);
+
+                    hasGradient = _mm256_and_ps(hasGradient, _mm256_cmp_ps(cosPhi2, one, _CMP_NEQ_UQ));
+
+                    __m256 arcosDerivative = _mm256_div_ps(_mm256_set1_ps(-1.0f), _mm256_sqrt_ps(_mm256_sub_ps(one, cosPhi2)));
+
+                    arcosDerivative = _mm256_xor_ps(arcosDerivative, _mm256_and_ps(isReflex, signMask));
+
+                    Vec3AVX2 dp1 = Add(Div(Add(Cross(er, n1), Scale(cosPhi, Cross(n2, er))), l2), Div(Add(Cross(el, n2), Scale(cosPhi, Cross(n1, el))), l1));
+                    Vec3AVX2 dp2 = Div(Sub(Cross(n2, em), Scale(cosPhi, Cross(n1, em))), l1);
+                    Vec3AVX2 dp3 = Div(Sub(Cross(n1, em), Scale(cosPhi, Cross(n2, em))), l2);
+
+                    Vec3AVX2 gradient[4];
+
+                    gradient[1] = Scale(arcosDerivative, dp1);
+                    gradient[2] = Scale(arcosDerivative, dp2);
+                    gradient[3] = Scale(arcosDerivative, dp3);
+
+                    Vec3AVX2 negated = { _mm256_xor_ps(gradient[1].x, signMask), _mm256_xor_ps(gradient[1].y, signMask), _mm256_xor_ps(gradient[1].z, signMask) };
+
+                    gradient[0] = Sub(Sub(negated, gradient[2]), gradient[3]);
+
+                    __m256 xpbdFactor  = _mm256_div_ps(_mm256_loadu_ps(compliances + c), deltaTime2);
+                    __m256 denominator = xpbdFactor;
+
+                    for (int i = 0; i < 4; i++)
+                        denominator = _mm256_add_ps(denominator, _mm256_mul_ps(w[i], Dot(gradient[i], gradient[i])));
+                    __m256 satisfied = _mm256_cmp_ps(_mm256_andnot_ps(signMask, value), epsilon, _CMP_LE_OQ);
+                    __m256 active    = _mm256_andnot_ps(satisfied, _mm256_and_ps(hasGradient, _mm256_cmp_ps(denominator, epsilon, _CMP_NLT_UQ)));
+
+                    __m256 lambda      = _mm256_loadu_ps(lambdas + c);
+                    __m256 negValue    = _mm256_xor_ps(value, signMask);
+                    __m256 numerator   = _mm256_sub_ps(negValue, _mm256_mul_ps(xpbdFactor, lambda));
+                    __m256 deltaLambda = _mm256_div_ps(numerator, denominator);
+
+                    deltaLambda = _mm256_and_ps(_mm256_cmp_ps(deltaLambda, deltaLambda, _CMP_ORD_Q), deltaLambda);
+
+                    _mm256_storeu_ps(lambdas + c, Select(active, _mm256_add_ps(lambda, deltaLambda), lambda));
+
+                    __m256 scale = _mm256_div_ps(negValue, denominator);
+
+                    alignas(32) float x[8], y[8], z[8];
+                    alignas(32) int   offset[8];
+
+                    for (int i = 0; i < 4; i++) {
+                        Vec3AVX2 moved = Add(p[i], Scale(_mm256_mul_ps(scale, w[i]), gradient[i]));
+
+                        _mm256_store_ps(x, Select(active, moved.x, p[i].x));
+                        _mm256_store_ps(y, Select(active, moved.y, p[i].y));
+                        _mm256_store_ps(z, Select(active, moved.z, p[i].z));
+                        _mm256_store_si256((__m256i *)offset, offsets[i]);
+
+                        for (int k = 0; k < 8; k++) {
+                            positions[offset[k]] = x[k]; positions[offset[k] + 1] = y[k]; positions[offset[k] + 2] = z[k];
+                        }
+                    }
+                }
+
+                return c;
+            }
+#endif
+    };
+};
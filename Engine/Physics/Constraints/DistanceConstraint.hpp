@@ -1,11 +1,44 @@
 #pragma once
 
 #include "Constraint.hpp"
+#include "DistanceKernelSimd.hpp"
 
 #include <glm/geometric.hpp>
+#include <array>
 
 namespace Exodia {
 
+    /**
+    * @brief Fused evaluation of a distance constraint for ConstraintBatch.
+    */
+    struct DistanceKernel {
+
+        static constexpr unsigned int   Arity = 2;
+        static constexpr ConstraintType Type  = EQUALITY;
+
+        using RestValue = float;
+
+        static bool Evaluate(const std::array<glm::vec3, 2> &p, float restLength, float &value, std::array<glm::vec3, 2> &gradient)
+        {
+            glm::vec3 delta  = p[0] - p[1];
+            float     length = glm::length(delta);
+
+            value = length - restLength;
+
+            if (length < 1e-6f)
+                return false;
+            gradient[0] =  delta / length;
+            gradient[1] = -gradient[0];
+
+            return true;
+        }
+
+        static std::size_t SolveColor(const std::array<int, 2> *indices, const float *restLengths, const float *compliances, float *lambdas, std::size_t count, glm::vec3 *positions, const float *inverseMasses, float deltaTime)
+        {
+            return DistanceKernelSimd::SolveColor(indices, restLengths, compliances, lambdas, count, positions, inverseMasses, deltaTime);
+        }
+    };
+
     class DistanceConstraint : public Constraint {
     
         public:
@@ -15,6 +48,14 @@ namespace Exodia {
                 _RestLength = glm::length(p1->Position - p2->Position);
             }
 
+            /**
+            * @brief Takes its rest length as is instead of measuring it, as when read back from a packed batch (see BodyCache).
+            */
+            DistanceConstraint(std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, float compliance, float restLength) : Constraint({ p1, p2 }, compliance, EQUALITY)
+            {
+                _RestLength = restLength;
+            }
+
             DistanceConstraint(const DistanceConstraint& other) : Constraint(other)
             {
                 _RestLength = other._RestLength;
@@ -25,6 +66,11 @@ namespace Exodia {
                 return glm::length(_Particles[0]->PredictedPosition - _Particles[1]->PredictedPosition) - _RestLength;
             }
 
+            float GetRestLength() const
+            {
+                return _RestLength;
+            }
+
         private:
 
             void ComputeGradient() override
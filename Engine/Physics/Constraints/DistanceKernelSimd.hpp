@@ -0,0 +1,212 @@
+#pragma once
+
+#include "Utils/Simd.hpp"
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace Exodia {
+
+    /**
+    * @brief Vectorized distance projection over one color, bitwise identical to DistanceKernel.
+    */
+    class DistanceKernelSimd {
+
+        public:
+
+            /**
+            * @brief Solves the largest multiple of the vector width of [0, count) and returns how many constraints it solved.
+            */
+            static std::size_t SolveColor(const std::array<int, 2> *indices, const float *restLengths, const float *compliances, float *lambdas, std::size_t count, glm::vec3 *positions, const float *inverseMasses, float deltaTime)
+            {
+                static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Positions are gathered as packed floats.");
+                static_assert(sizeof(std::array<int, 2>) == 2 * sizeof(int), "Indices are loaded as packed pairs.");
+
+#if defined(EXODIA_SIMD_X86)
+                switch (Simd::GetLevel()) {
+                    case SIMD_AVX2:
+                        return SolveColorAVX2(indices, restLengths, compliances, lambdas, count, &positions[0].x, inverseMasses, deltaTime);
+                    case SIMD_SSE:
+                        return SolveColorSSE(indices, restLengths, compliances, lambdas, count, &positions[0].x, inverseMasses, deltaTime);
+                    default:
+                        break;
+                }
+#endif
+                return 0;
+            }
+
+#if defined(EXODIA_SIMD_X86)
+        private:
+
+            static __m128 Select(__m128 mask, __m128 a, __m128 b)
+            {
+                return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+            }
+
+            static std::size_t SolveColorSSE(const std::array<int, 2> *indices, const float *restLengths, const float *compliances, float *lambdas, std::size_t count, float *positions, const float *inverseMasses, float deltaTime)
+            {
+                const __m128 deltaTime2 = _mm_set1_ps(deltaTime * deltaTime);
+                const __m128 epsilon    = _mm_set1_ps(1e-6f);
+                const __m128 signMask   = _mm_set1_ps(-0.0f);
+
+                std::size_t c = 0;
+
+                for (; c + 4 <= count; c += 4) {
+                    alignas(16) float ax[4], ay[4], az[4], bx[4], by[4], bz[4], wa[4], wb[4];
+
+                    for (int k = 0; k < 4; k++) {
+                        const float *a = positions + 3 * indices[c + k][0];
+                        const float *b = positions + 3 * indices[c + k][1];
+
+                        ax[k] = a[0]; ay[k] = a[1]; az[k] = a[2];
+                        bx[k] = b[0]; by[k] = b[1]; bz[k] = b[2];
+
+                        wa[k] = inverseMasses[indices[c + k][0]];
+                        wb[k] = inverseMasses[indices[c + k][1]];
+                    }
+
+                    __m128 pax = _mm_load_ps(ax), pay = _mm_load_ps(ay), paz = _mm_load_ps(az);
+                    __m128 pbx = _mm_load_ps(bx), pby = _mm_load_ps(by), pbz = _mm_load_ps(bz);
+                    __m128 wA  = _mm_load_ps(wa), wB  = _mm_load_ps(wb);
+
+                    __m128 dx = _mm_sub_ps(pax, pbx);
+                    __m128 dy = _mm_sub_ps(pay, pby);
+                    __m128 dz = _mm_sub_ps(paz, pbz);
+
+                    __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+                    __m128 value  = _mm_sub_ps(length, _mm_loadu_ps(restLengths + c));
+
+                    __m128 gx = _mm_div_ps(dx, length);
+                    __m128 gy = _mm_div_ps(dy, length);
+                    __m128 gz = _mm_div_ps(dz, length);
+                    __m128 gg = _mm_add_ps(_mm_add_ps(_mm_mul_ps(gx, gx), _mm_mul_ps(gy, gy)), _mm_mul_ps(gz, gz));
+
+                    __m128 xpbdFactor  = _mm_div_ps(_mm_loadu_ps(compliances + c), deltaTime2);
+                    __m128 denominator = _mm_add_ps(_mm_add_ps(xpbdFactor, _mm_mul_ps(wA, gg)), _mm_mul_ps(wB, gg));
+
+                    __m128 satisfied = _mm_cmple_ps(_mm_andnot_ps(signMask, value), epsilon);
+                    __m128 active    = _mm_andnot_ps(satisfied, _mm_and_ps(_mm_cmpnlt_ps(length, epsilon), _mm_cmpnlt_ps(denominator, epsilon)));
+
+                    __m128 lambda      = _mm_loadu_ps(lambdas + c);
+                    __m128 negValue    = _mm_xor_ps(value, signMask);
+                    __m128 numerator   = _mm_sub_ps(negValue, _mm_mul_ps(xpbdFactor, lambda));
+                    __m128 deltaLambda = _mm_div_ps(numerator, denominator);
+
+                    deltaLambda = _mm_and_ps(_mm_cmpord_ps(deltaLambda, deltaLambda), deltaLambda);
+
+                    _mm_storeu_ps(lambdas + c, Select(active, _mm_add_ps(lambda, deltaLambda), lambda));
+
+                    __m128 scale  = _mm_div_ps(negValue, denominator);
+                    __m128 scaleA = _mm_mul_ps(scale, wA);
+                    __m128 scaleB = _mm_mul_ps(scale, wB);
+
+                    _mm_store_ps(ax, Select(active, _mm_add_ps(pax, _mm_mul_ps(scaleA, gx)), pax));
+                    _mm_store_ps(ay, Select(active, _mm_add_ps(pay, _mm_mul_ps(scaleA, gy)), pay));
+                    _mm_store_ps(az, Select(active, _mm_add_ps(paz, _mm_mul_ps(scaleA, gz)), paz));
+                    _mm_store_ps(bx, Select(active, _mm_sub_ps(pbx, _mm_mul_ps(scaleB, gx)), pbx));
+                    _mm_store_ps(by, Select(active, _mm_sub_ps(pby, _mm_mul_ps(scaleB, gy)), pby));
+                    _mm_store_ps(bz, Select(active, _mm_sub_ps(pbz, _mm_mul_ps(scaleB, gz)), pbz));
+
+                    for (int k = 0; k < 4; k++) {
+                        float *a = positions + 3 * indices[c + k][0];
+                        float *b = positions + 3 * indices[c + k][1];
+
+                        a[0] = ax[k]; a[1] = ay[k]; a[2] = az[k];
+                        b[0] = bx[k]; b[1] = by[k]; b[2] = bz[k];
+                    }
+                }
+
+                return c;
+            }
+
+            EXODIA_TARGET_AVX2 static __m256 Select(__m256 mask, __m256 a, __m256 b)
+            {
+                return _mm256_blendv_ps(b, a, mask);
+            }
+
+            EXODIA_TARGET_AVX2 static std::size_t SolveColorAVX2(const std::array<int, 2> *indices, const float *restLengths, const float *compliances, float *lambdas, std::size_t count, float *positions, const float *inverseMasses, float deltaTime)
+            {
+                const __m256 deltaTime2 = _mm256_set1_ps(deltaTime * deltaTime);
+                const __m256 epsilon    = _mm256_set1_ps(1e-6f);
+                const __m256 signMask   = _mm256_set1_ps(-0.0f);
+
+                std::size_t c = 0;
+
+                for (; c + 8 <= count; c += 8) {
+                    // indices holds (a, b) pairs: split them into one register of a and one of b.
+                    __m256i pairs0 = _mm256_loadu_si256((const __m256i *)(indices + c));
+                    __m256i pairs1 = _mm256_loadu_si256((const __m256i *)(indices + c + 4));
+                    __m256i order  = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+                    pairs0 = _mm256_permutevar8x32_epi32(pairs0, order);
+                    pairs1 = _mm256_permutevar8x32_epi32(pairs1, order);
+
+                    __m256i indexA = _mm256_permute2x128_si256(pairs0, pairs1, 0x20);
+                    __m256i indexB = _mm256_permute2x128_si256(pairs0, pairs1, 0x31);
+                    __m256i offsetA = _mm256_mullo_epi32(indexA, _mm256_set1_epi32(3));
+                    __m256i offsetB = _mm256_mullo_epi32(indexB, _mm256_set1_epi32(3));
+
+                    __m256 pax = _mm256_i32gather_ps(positions    , offsetA, 4);
+                    __m256 pay = _mm256_i32gather_ps(positions + 1, offsetA, 4);
+                    __m256 paz = _mm256_i32gather_ps(positions + 2, offsetA, 4);
+                    __m256 pbx = _mm256_i32gather_ps(positions    , offsetB, 4);
+                    __m256 pby = _mm256_i32gather_ps(positions + 1, offsetB, 4);
+                    __m256 pbz = _mm256_i32gather_ps(positions + 2, offsetB, 4);
+                    __m256 wA  = _mm256_i32gather_ps(inverseMasses, indexA, 4);
+                    __m256 wB  = _mm256_i32gather_ps(inverseMasses, indexB, 4);
+
+                    __m256 dx = _mm256_sub_ps(pax, pbx);
+                    __m256 dy = _mm256_sub_ps(pay, pby);
+                    __m256 dz = _mm256_sub_ps(paz, pbz);
+
+                    __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz)));
+                    __m256 value  = _mm256_sub_ps(length, _mm256_loadu_ps(restLengths + c));
+
+                    __m256 gx = _mm256_div_ps(dx, length);
+                    __m256 gy = _mm256_div_ps(dy, length);
+                    __m256 gz = _mm256_div_ps(dz, length);
+                    __m256 gg = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(gx, gx), _mm256_mul_ps(gy, gy)), _mm256_mul_ps(gz, gz));
+
+                    __m256 xpbdFactor  = _mm256_div_ps(_mm256_loadu_ps(compliances + c), deltaTime2);
+                    __m256 denominator = _mm256_add_ps(_mm256_add_ps(xpbdFactor, _mm256_mul_ps(wA, gg)), _mm256_mul_ps(wB, gg));
+
+                    __m256 satisfied = _mm256_cmp_ps(_mm256_andnot_ps(signMask, value), epsilon, _CMP_LE_OQ);
+                    __m256 active    = _mm256_andnot_ps(satisfied, _mm256_and_ps(_mm256_cmp_ps(length, epsilon, _CMP_NLT_UQ), _mm256_cmp_ps(denominator, epsilon, _CMP_NLT_UQ)));
+
+                    __m256 lambda      = _mm256_loadu_ps(lambdas + c);
+                    __m256 negValue    = _mm256_xor_ps(value, signMask);
+                    __m256 numerator   = _mm256_sub_ps(negValue, _mm256_mul_ps(xpbdFactor, lambda));
+                    __m256 deltaLambda = _mm256_div_ps(numerator, denominator);
+
+                    deltaLambda = _mm256_and_ps(_mm256_cmp_ps(deltaLambda, deltaLambda, _CMP_ORD_Q), deltaLambda);
+
+                    _mm256_storeu_ps(lambdas + c, Select(active, _mm256_add_ps(lambda, deltaLambda), lambda));
+
+                    __m256 scale  = _mm256_div_ps(negValue, denominator);
+                    __m256 scaleA = _mm256_mul_ps(scale, wA);
+                    __m256 scaleB = _mm256_mul_ps(scale, wB);
+
+                    alignas(32) float ax[8], ay[8], az[8], bx[8], by[8], bz[8];
+                    alignas(32) int   ia[8], ib[8];
+
+                    _mm256_store_ps(ax, Select(active, _mm256_add_ps(pax, _mm256_mul_ps(scaleA, gx)), pax));
+                    _mm256_store_ps(ay, Select(active, _mm256_add_ps(pay, _mm256_mul_ps(scaleA, gy)), pay));
+                    _mm256_store_ps(az, Select(active, _mm256_add_ps(paz, _mm256_mul_ps(scaleA, gz)), paz));
+                    _mm256_store_ps(bx, Select(active, _mm256_sub_ps(pbx, _mm256_mul_ps(scaleB, gx)), pbx));
+                    _mm256_store_ps(by, Select(active, _mm256_sub_ps(pby, _mm256_mul_ps(scaleB, gy)), pby));
+                    _mm256_store_ps(bz, Select(active, _mm256_sub_ps(pbz, _mm256_mul_ps(scaleB, gz)), pbz));
+                    _mm256_store_si256((__m256i *)ia, offsetA);
+                    _mm256_store_si256((__m256i *)ib, offsetB);
+
+                    for (int k = 0; k < 8; k++) {
+                        positions[ia[k]] = ax[k]; positions[ia[k] + 1] = ay[k]; positions[ia[k] + 2] = az[k];
+                        positions[ib[k]] = bx[k]; positions[ib[k] + 1] = by[k]; positions[ib[k] + 2] = bz[k];
+                    }
+                }
+
+                return c;
+            }
+#endif
+    };
+};
@@ -2,6 +2,7 @@
 
 #include "DistanceConstraint.hpp"
 
+#include <array>
 #include <glm/geometric.hpp>
 
 namespace Exodia {
@@ -13,6 +14,27 @@ namespace Exodia {
 
         public:
 
-            FastBendConstraint(std::shared_ptr<Particle> p0, std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, std::shared_ptr<Particle> p3, float compliance) : DistanceConstraint(p2, p3, compliance) {};
+            FastBendConstraint(std::shared_ptr<Particle> p0, std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, std::shared_ptr<Particle> p3, float compliance) : DistanceConstraint(p2, p3, compliance), _Edge({ p0, p1 }) {};
+
+            FastBendConstraint(std::shared_ptr<Particle> p0, std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, std::shared_ptr<Particle> p3, float compliance, float restLength) : DistanceConstraint(p2, p3, compliance, restLength), _Edge({ p0, p1 }) {};
+
+        public:
+
+            /**
+            * @brief Particles of the edge the two triangles share, not part of the constraint but telling which triangles it spans.
+            */
+            const std::array<std::shared_ptr<Particle>, 2> &GetEdge() const
+            {
+                return _Edge;
+            }
+
+            void SetEdge(std::array<std::shared_ptr<Particle>, 2> edge)
+            {
+                _Edge = std::move(edge);
+            }
+
+        private:
+
+            std::array<std::shared_ptr<Particle>, 2> _Edge;
     };
 };
@@ -19,6 +19,11 @@ namespace Exodia {
                 return glm::length(_Particles[0]->PredictedPosition - _TargetPosition);
             }
 
+            glm::vec3 GetTargetPosition() const
+            {
+                return _TargetPosition;
+            }
+
         private:
 
             void ComputeGradient() override
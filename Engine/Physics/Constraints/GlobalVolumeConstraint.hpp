@@ -1,82 +1,83 @@
 #pragma once
 
 #include "Constraint.hpp"
+#include "GlobalVolumeKernelSimd.hpp"
+#include "Utils/ThreadPool.hpp"
 
+#include <array>
+#include <cmath>
 #include <glm/geometric.hpp>
 #include <iostream>
 
 namespace Exodia {
 
+    /**
+    * @brief Keeps the volume enclosed by a closed triangulation at its rest volume times the pressure.
+    */
     class GlobalVolumeConstraint : public Constraint {
 
         public:
 
             GlobalVolumeConstraint(std::vector<std::shared_ptr<Particle>> particles, std::vector<int> indices, float pressure, float compliance) : Constraint(particles, compliance, EQUALITY), _Pressure(pressure), _Indices(indices)
             {
-                float volume = 0;
+                BuildCorners();
 
-                for (int i = 0; i < _Indices.size(); i += 3) {
-                    glm::vec3 t0 = _Particles[_Indices[i    ]]->Position;
-                    glm::vec3 t1 = _Particles[_Indices[i + 1]]->Position;
-                    glm::vec3 t2 = _Particles[_Indices[i + 2]]->Position;
-
-                    volume += glm::dot(t0, glm::cross(t1, t2)) / 6.0f;
-                }
-
-                _RestVolume = volume;
+                _RestVolume = ComputeVolume(&Particle::Position);
             }
 
         public:
 
             float Evaluate() const override
             {
-                float volume = 0;
+                return ComputeVolume(&Particle::PredictedPosition) - _RestVolume * _Pressure;
+            }
+
+            using Constraint::Solve;
+
+            /**
+            * @brief Same update as Constraint::Solve, on the flat positions gathered by the body.
+            */
+            void Solve(std::vector<glm::vec3> &positions, const std::vector<float> &inverseMasses, float deltaTime)
+            {
+                glm::vec2 volumeAndDenominator = ComputeVolumeAndGradient(positions.data(), inverseMasses.data());
 
-                for (int i = 0; i < _Indices.size(); i += 3) {
-                    glm::vec3 t0 = _Particles[_Indices[i    ]]->PredictedPosition;
-                    glm::vec3 t1 = _Particles[_Indices[i + 1]]->PredictedPosition;
-                    glm::vec3 t2 = _Particles[_Indices[i + 2]]->PredictedPosition;
+                float constraintValue = volumeAndDenominator.x - _RestVolume * _Pressure;
 
-                    volume += glm::dot(t0, glm::cross(t1, t2)) / 6.0f;
-                }
+                if (IsSatisfied(constraintValue))
+                    return;
+                float xpbdFactor  = _Compliance / (deltaTime * deltaTime);
+                float numerator   = -constraintValue - xpbdFactor * _Lambda;
+                float denominator = xpbdFactor + volumeAndDenominator.y;
 
-                return volume - _RestVolume * _Pressure;
+                if (denominator < 1e-6f)
+                    return;
+                float deltaLambda = numerator / denominator;
+                float scale       = -constraintValue / denominator;
+
+                if (std::isnan(deltaLambda))
+                    deltaLambda = 0.0f;
+                ThreadPool::Get().ParallelFor(_VolumeGradient.size(), VOLUME_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; i++)
+                        positions[i] += scale * inverseMasses[i] * _VolumeGradient[i];
+                });
+
+                _Lambda += deltaLambda;
             }
 
         private:
-        
+
             void ComputeGradient() override
             {
-                std::fill(_Gradient.begin(), _Gradient.end(), glm::vec3(0.0f));
-
-                for (int i = 0; i < _Indices.size(); i += 3) {
-                    glm::vec3 p0 = _Particles[_Indices[i    ]]->PredictedPosition;
-                    glm::vec3 p1 = _Particles[_Indices[i + 1]]->PredictedPosition;
-                    glm::vec3 p2 = _Particles[_Indices[i + 2]]->PredictedPosition;
+                std::vector<glm::vec3> positions = GatherPositions(&Particle::PredictedPosition);
 
-                    glm::vec3 g1 = glm::cross(p1, p2) / 6.0f;
-                    glm::vec3 g2 = glm::cross(p2, p0) / 6.0f;
-                    glm::vec3 g3 = glm::cross(p0, p1) / 6.0f;
+                ComputeVolumeAndGradient(positions.data(), nullptr);
 
-                    _Gradient[_Indices[i    ]] += g1;
-                    _Gradient[_Indices[i + 1]] += g2;
-                    _Gradient[_Indices[i + 2]] += g3;
-                }
+                std::copy(_VolumeGradient.begin(), _VolumeGradient.end(), _Gradient.begin());
             }
 
             void RecomputeTargetValue() override
             {
-                float volume = 0;
-
-                for (int i = 0; i < _Indices.size(); i += 3) {
-                    glm::vec3 t0 = _Particles[_Indices[i    ]]->PredictedPosition;
-                    glm::vec3 t1 = _Particles[_Indices[i + 1]]->PredictedPosition;
-                    glm::vec3 t2 = _Particles[_Indices[i + 2]]->PredictedPosition;
-
-                    volume += glm::dot(t0, glm::cross(t1, t2)) / 6.0f;
-                }
-
-                _RestVolume = volume;
+                _RestVolume = ComputeVolume(&Particle::PredictedPosition);
             }
 
         public:
@@ -91,11 +92,119 @@ namespace Exodia {
                 return _Pressure;
             }
 
+            /**
+            * @brief Triangles enclosing the volume, as indices in the particles.
+            */
+            const std::vector<int> &GetIndices() const
+            {
+                return _Indices;
+            }
+
+            void RemapParticles(const std::vector<std::shared_ptr<Particle>> &particles, const std::vector<int> &newIndices)
+            {
+                _Particles.assign(particles.begin(), particles.begin() + _Particles.size());
+
+                for (int& index : _Indices)
+                    index = newIndices[index];
+                BuildCorners();
+            }
+
         private:
 
+            void BuildCorners()
+            {
+                std::size_t nbParticles = _Particles.size();
+
+                _CornerOffsets.assign(nbParticles + 1, 0);
+
+                for (int index : _Indices)
+                    _CornerOffsets[index + 1]++;
+                for (std::size_t i = 0; i < nbParticles; i++)
+                    _CornerOffsets[i + 1] += _CornerOffsets[i];
+                std::vector<int> cursor(_CornerOffsets.begin(), _CornerOffsets.end() - 1);
+
+                _Corners.resize(_Indices.size());
+
+                for (std::size_t i = 0; i + 2 < _Indices.size(); i += 3) {
+                    int i0 = _Indices[i], i1 = _Indices[i + 1], i2 = _Indices[i + 2];
+
+                    _Corners[cursor[i0]++] = { i1, i2 };
+                    _Corners[cursor[i1]++] = { i2, i0 };
+                    _Corners[cursor[i2]++] = { i0, i1 };
+                }
+
+                _CornerCrossesX.resize(_Corners.size());
+                _CornerCrossesY.resize(_Corners.size());
+                _CornerCrossesZ.resize(_Corners.size());
+                _VolumeGradient.resize(nbParticles);
+            }
+
+            std::vector<glm::vec3> GatherPositions(glm::vec3 Particle::*position) const
+            {
+                std::vector<glm::vec3> positions(_Particles.size());
+
+                for (std::size_t i = 0; i < _Particles.size(); i++)
+                    positions[i] = (*_Particles[i]).*position;
+                return positions;
+            }
+
+            float ComputeVolume(glm::vec3 Particle::*position) const
+            {
+                std::vector<glm::vec3> positions = GatherPositions(position);
+
+                return ComputeVolumeAndGradient(positions.data(), nullptr).x;
+            }
+
+            /**
+            * @brief Fills _VolumeGradient, returns the signed volume and the sum of w_i * |gradient_i|^2.
+            */
+            glm::vec2 ComputeVolumeAndGradient(const glm::vec3 *positions, const float *inverseMasses) const
+            {
+                ThreadPool &pool = ThreadPool::Get();
+
+                pool.ParallelFor(_Corners.size(), VOLUME_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    GlobalVolumeKernelSimd::ComputeCornerCrosses(&_Corners[begin], end - begin, positions, &_CornerCrossesX[begin], &_CornerCrossesY[begin], &_CornerCrossesZ[begin]);
+                });
+
+                glm::vec2 sums = pool.ParallelReduce(_VolumeGradient.size(), VOLUME_GRAIN_SIZE, glm::vec2(0.0f), [&](std::size_t begin, std::size_t end) {
+                    glm::vec2 partial(0.0f);
+
+                    for (std::size_t i = begin; i < end; i++) {
+                        glm::vec3 gradient(0.0f);
+
+                        for (int k = _CornerOffsets[i]; k < _CornerOffsets[i + 1]; k++)
+                            gradient += glm::vec3(_CornerCrossesX[k], _CornerCrossesY[k], _CornerCrossesZ[k]);
+                        gradient /= 6.0f;
+
+                        _VolumeGradient[i] = gradient;
+
+                        partial.x += glm::dot(positions[i], gradient);
+
+                        if (inverseMasses != nullptr)
+                            partial.y += inverseMasses[i] * glm::dot(gradient, gradient);
+                    }
+
+                    return partial;
+                }, [](glm::vec2 a, glm::vec2 b) { return a + b; });
+
+                return glm::vec2(sums.x / 3.0f, sums.y);
+            }
+
+        private:
+
+            static constexpr std::size_t VOLUME_GRAIN_SIZE = 1024;
+
             float _RestVolume {};
             float _Pressure   {};
 
             std::vector<int> _Indices;
+
+            std::vector<int>                _CornerOffsets;
+            std::vector<std::array<int, 2>> _Corners;
+
+            mutable std::vector<float>     _CornerCrossesX;
+            mutable std::vector<float>     _CornerCrossesY;
+            mutable std::vector<float>     _CornerCrossesZ;
+            mutable std::vector<glm::vec3> _VolumeGradient;
     };
 };
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Utils/Simd.hpp"
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace Exodia {
+
+    /**
+    * @brief Vectorized cross products of the triangle corners, bitwise identical to glm::cross.
+    */
+    class GlobalVolumeKernelSimd {
+
+        public:
+
+            static void ComputeCornerCrosses(const std::array<int, 2> *corners, std::size_t count, const glm::vec3 *positions, float *crossX, float *crossY, float *crossZ)
+            {
+                static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "Positions are gathered as packed floats.");
+                static_assert(sizeof(std::array<int, 2>) == 2 * sizeof(int), "Corners are loaded as packed pairs.");
+
+                std::size_t k = 0;
+
+#if defined(EXODIA_SIMD_X86)
+                switch (Simd::GetLevel()) {
+                    case SIMD_AVX2:
+                        k = ComputeCornerCrossesAVX2(corners, count, &positions[0].x, crossX, crossY, crossZ);
+                        break;
+                    case SIMD_SSE:
+                        k = ComputeCornerCrossesSSE(corners, count, &positions[0].x, crossX, crossY, crossZ);
+                        break;
+                    default:
+                        break;
+                }
+#endif
+
+                for (; k < count; k++) {
+                    glm::vec3 cross = glm::cross(positions[corners[k][0]], positions[corners[k][1]]);
+
+                    crossX[k] = cross.x;
+                    crossY[k] = cross.y;
+                    crossZ[k] = cross.z;
+                }
+            }
+
+#if defined(EXODIA_SIMD_X86)
+        private:
+
+            static std::size_t ComputeCornerCrossesSSE(const std::array<int, 2> *corners, std::size_t count, const float *positions, float *crossX, float *crossY, float *crossZ)
+            {
+                std::size_t k = 0;
+
+                for (; k + 4 <= count; k += 4) {
+                    alignas(16) float ax[4], ay[4], az[4], bx[4], by[4], bz[4];
+
+                    for (int lane = 0; lane < 4; lane++) {
+                        const float *a = positions + 3 * corners[k + lane][0];
+                        const float *b = positions + 3 * corners[k + lane][1];
+
+                        ax[lane] = a[0]; ay[lane] = a[1]; az[lane] = a[2];
+                        bx[lane] = b[0]; by[lane] = b[1]; bz[lane] = b[2];
+                    }
+
+                    __m128 pax = _mm_load_ps(ax), pay = _mm_load_ps(ay), paz = _mm_load_ps(az);
+                    __m128 pbx = _mm_load_ps(bx), pby = _mm_load_ps(by), pbz = _mm_load_ps(bz);
+
+                    _mm_storeu_ps(crossX + k, _mm_sub_ps(_mm_mul_ps(pay, pbz), _mm_mul_ps(pby, paz)));
+                    _mm_storeu_ps(crossY + k, _mm_sub_ps(_mm_mul_ps(paz, pbx), _mm_mul_ps(pbz, pax)));
+                    _mm_storeu_ps(crossZ + k, _mm_sub_ps(_mm_mul_ps(pax, pby), _mm_mul_ps(pbx, pay)));
+                }
+
+                return k;
+            }
+
+            EXODIA_TARGET_AVX2 static std::size_t ComputeCornerCrossesAVX2(const std::array<int, 2> *corners, std::size_t count, const float *positions, float *crossX, float *crossY, float *crossZ)
+            {
+                const __m256i order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+                const __m256i three = _mm256_set1_epi32(3);
+
+                std::size_t k = 0;
+
+                for (; k + 8 <= count; k += 8) {
+                    __m256i pairs0 = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)(corners + k    )), order);
+                    __m256i pairs1 = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i *)(corners + k + 4)), order);
+
+                    __m256i offsetA = _mm256_mullo_epi32(_mm256_permute2x128_si256(pairs0, pairs1, 0x20), three);
+                    __m256i offsetB = _mm256_mullo_epi32(_mm256_permute2x128_si256(pairs0, pairs1, 0x31), three);
+
+                    __m256 pax = _mm256_i32gather_ps(positions    , offsetA, 4);
+                    __m256 pay = _mm256_i32gather_ps(positions + 1, offsetA, 4);
+                    __m256 paz = _mm256_i32gather_ps(positions + 2, offsetA, 4);
+                    __m256 pbx = _mm256_i32gather_ps(positions    , offsetB, 4);
+                    __m256 pby = _mm256_i32gather_ps(positions + 1, offsetB, 4);
+                    __m256 pbz = _mm256_i32gather_ps(positions + 2, offsetB, 4);
+
+                    _mm256_storeu_ps(crossX + k, _mm256_sub_ps(_mm256_mul_ps(pay, pbz), _mm256_mul_ps(pby, paz)));
+                    _mm256_storeu_ps(crossY + k, _mm256_sub_ps(_mm256_mul_ps(paz, pbx), _mm256_mul_ps(pbz, pax)));
+                    _mm256_storeu_ps(crossZ + k, _mm256_sub_ps(_mm256_mul_ps(pax, pby), _mm256_mul_ps(pbx, pay)));
+                }
+
+                return k;
+            }
+#endif
+    };
+};
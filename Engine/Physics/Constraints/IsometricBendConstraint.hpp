@@ -0,0 +1,134 @@
+#pragma once
+
+#include "Constraint.hpp"
+
+#include <glm/geometric.hpp>
+#include <array>
+#include <cmath>
+
+namespace Exodia {
+
+    /**
+    * @brief Fused evaluation of an isometric bend constraint for ConstraintBatch.
+    */
+    struct IsometricBendKernel {
+
+        static constexpr unsigned int   Arity = 4;
+        static constexpr ConstraintType Type  = EQUALITY;
+
+        struct RestValue {
+            std::array<float, 4> Weights {};
+            float                Energy  {};
+        };
+
+        static RestValue ComputeRestValue(const std::array<glm::vec3, 4> &p)
+        {
+            RestValue restValue;
+
+            glm::vec3 e0 = p[1] - p[0];
+            glm::vec3 e1 = p[2] - p[0];
+            glm::vec3 e2 = p[3] - p[0];
+            glm::vec3 e3 = p[2] - p[1];
+            glm::vec3 e4 = p[3] - p[1];
+
+            float doubleArea0 = glm::length(glm::cross(e0, e1));
+            float doubleArea1 = glm::length(glm::cross(e0, e2));
+
+            if (doubleArea0 == 0.0f || doubleArea1 == 0.0f)
+                return restValue;
+            float c01 = Cotangent( e0, e1);
+            float c02 = Cotangent( e0, e2);
+            float c03 = Cotangent(-e0, e3);
+            float c04 = Cotangent(-e0, e4);
+
+            float scale = sqrtf(3.0f / (doubleArea0 + doubleArea1));
+
+            restValue.Weights = { scale * (c03 + c04), scale * (c01 + c02), -scale * (c01 + c03), -scale * (c02 + c04) };
+
+            float value = 0.0f;
+            std::array<glm::vec3, 4> gradient;
+
+            Evaluate(p, restValue, value, gradient);
+
+            restValue.Energy = value;
+
+            return restValue;
+        }
+
+        static bool Evaluate(const std::array<glm::vec3, 4> &p, const RestValue &restValue, float &value, std::array<glm::vec3, 4> &gradient)
+        {
+            glm::vec3 curvature = restValue.Weights[0] * p[0] + restValue.Weights[1] * p[1] + restValue.Weights[2] * p[2] + restValue.Weights[3] * p[3];
+
+            value = -0.5f * glm::dot(curvature, curvature) - restValue.Energy;
+
+            for (unsigned int i = 0; i < 4; i++)
+                gradient[i] = -restValue.Weights[i] * curvature;
+            return true;
+        }
+
+    private:
+
+        static float Cotangent(const glm::vec3 &a, const glm::vec3 &b)
+        {
+            float sine = glm::length(glm::cross(a, b));
+
+            return sine == 0.0f ? 0.0f : glm::dot(a, b) / sine;
+        }
+    };
+
+    class IsometricBendConstraint : public Constraint {
+
+        public:
+
+            IsometricBendConstraint(std::shared_ptr<Particle> p0, std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, std::shared_ptr<Particle> p3, float compliance) : Constraint({ p0, p1, p2, p3 }, compliance, EQUALITY)
+            {
+                _RestValue = IsometricBendKernel::ComputeRestValue(Positions(&Particle::Position));
+            };
+
+            IsometricBendConstraint(std::shared_ptr<Particle> p0, std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, std::shared_ptr<Particle> p3, float compliance, const IsometricBendKernel::RestValue &restValue) : Constraint({ p0, p1, p2, p3 }, compliance, EQUALITY), _RestValue(restValue) {};
+
+        public:
+
+            float Evaluate() const override
+            {
+                float value = 0.0f;
+                std::array<glm::vec3, 4> gradient;
+
+                IsometricBendKernel::Evaluate(Positions(&Particle::PredictedPosition), _RestValue, value, gradient);
+
+                return value;
+            }
+
+            const IsometricBendKernel::RestValue &GetRestValue() const
+            {
+                return _RestValue;
+            }
+
+        private:
+
+            void ComputeGradient() override
+            {
+                float value = 0.0f;
+                std::array<glm::vec3, 4> gradient;
+
+                IsometricBendKernel::Evaluate(Positions(&Particle::PredictedPosition), _RestValue, value, gradient);
+
+                for (unsigned int i = 0; i < 4; i++)
+                    _Gradient[i] = gradient[i];
+            }
+
+            void RecomputeTargetValue() override
+            {
+                _RestValue = IsometricBendKernel::ComputeRestValue(Positions(&Particle::Position));
+            }
+
+            std::array<glm::vec3, 4> Positions(glm::vec3 Particle::*position) const
+            {
+                return { (*_Particles[0]).*position, (*_Particles[1]).*position, (*_Particles[2]).*position, (*_Particles[3]).*position };
+            }
+
+        private:
+
+            IsometricBendKernel::RestValue _RestValue;
+    };
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "Bodies/RigidBody.hpp"
+#include "Particle/Particle.hpp"
+
+#include <array>
+#include <cmath>
+#include <glm/geometric.hpp>
+
+namespace Exodia {
+
+    /**
+    * @brief Keeps a point above a triangle of a rigid body, with friction.
+    */
+    class RigidContactConstraint {
+
+        public:
+
+            RigidContactConstraint(std::shared_ptr<Particle> particle, std::shared_ptr<RigidBody> body, std::array<int, 3> triangle) : _Particle(particle), _Body(body), _Triangle(triangle) {};
+
+            RigidContactConstraint(std::shared_ptr<RigidBody> pointBody, int vertex, std::shared_ptr<RigidBody> body, std::array<int, 3> triangle) : _PointBody(pointBody), _PointVertex(vertex), _Body(body), _Triangle(triangle) {};
+
+        public:
+
+            float Evaluate() const
+            {
+                glm::vec3 normal;
+
+                return Evaluate(normal);
+            }
+
+            /**
+            * @brief Pushes the point out of the triangle, remembering the penetration for SolveFriction.
+            */
+            void Solve()
+            {
+                glm::vec3 normal;
+
+                float constraintValue = Evaluate(normal);
+
+                _Penetration = 0.0f;
+
+                if (constraintValue >= 0.0f)
+                    return;
+                glm::vec3 point = GetPoint();
+
+                float pointInverseMass = _Particle != nullptr ? _Particle->InverseMass : _PointBody->GetGeneralizedInverseMass(point, normal);
+                float denominator      = pointInverseMass + _Body->GetGeneralizedInverseMass(point, normal);
+
+                if (denominator < 1e-6f)
+                    return;
+                _Penetration = -constraintValue;
+                _Normal      = normal;
+
+                ApplyImpulse((_Penetration / denominator) * normal, point, pointInverseMass);
+            }
+
+            /**
+            * @brief Friction of the contact, if Solve pushed it out.
+            */
+            void SolveFriction()
+            {
+                if (_Penetration == 0.0f)
+                    return;
+                glm::vec3 point = GetPoint();
+
+                glm::vec3 previousPoint = _Particle != nullptr ? _Particle->Position : _PointBody->GetPreviousWorldPoint(point);
+                glm::vec3 motion        = _Body->GetPreviousWorldPoint(point) - previousPoint;
+                glm::vec3 slip          = motion - glm::dot(motion, _Normal) * _Normal;
+
+                float slipLength = glm::length(slip);
+
+                if (slipLength < 1e-9f)
+                    return;
+                glm::vec3 tangent = slip / slipLength;
+
+                if (slipLength >= _StaticFriction * _Penetration)
+                    slipLength = _DynamicFriction * _Penetration;
+                float pointInverseMass = _Particle != nullptr ? _Particle->InverseMass : _PointBody->GetGeneralizedInverseMass(point, tangent);
+                float denominator      = pointInverseMass + _Body->GetGeneralizedInverseMass(point, tangent);
+
+                if (denominator < 1e-6f)
+                    return;
+                ApplyImpulse((-slipLength / denominator) * tangent, point, pointInverseMass);
+            }
+
+            std::shared_ptr<RigidBody> GetBody() const
+            {
+                return _Body;
+            }
+
+            std::shared_ptr<Particle> GetParticle() const
+            {
+                return _Particle;
+            }
+
+        private:
+
+            void ApplyImpulse(glm::vec3 impulse, glm::vec3 point, float pointInverseMass)
+            {
+                if (_Particle != nullptr)
+                    _Particle->PredictedPosition += pointInverseMass * impulse;
+                else
+                    _PointBody->ApplyPositionalImpulse(impulse, point);
+                _Body->ApplyPositionalImpulse(-impulse, point);
+            }
+
+            glm::vec3 GetPoint() const
+            {
+                return _Particle != nullptr ? _Particle->PredictedPosition : _PointBody->GetWorldVertex(_PointVertex);
+            }
+
+            float Evaluate(glm::vec3 &normal) const
+            {
+                glm::vec3 p1 = _Body->GetWorldVertex(_Triangle[0]);
+                glm::vec3 p2 = _Body->GetWorldVertex(_Triangle[1]);
+                glm::vec3 p3 = _Body->GetWorldVertex(_Triangle[2]);
+
+                normal = glm::cross(p2 - p1, p3 - p1);
+
+                if (glm::length(normal) < 1e-3f)
+                    return 0.0f;
+                normal = glm::normalize(normal);
+
+                return glm::dot(GetPoint() - p1, normal) - _H;
+            }
+
+        private:
+
+            std::shared_ptr<Particle>  _Particle;
+            std::shared_ptr<RigidBody> _PointBody;
+            int                        _PointVertex = -1;
+
+            std::shared_ptr<RigidBody> _Body;
+            std::array<int, 3>         _Triangle;
+
+            float _H               = 0.02f;
+            float _StaticFriction  = 0.5f;
+            float _DynamicFriction = 0.3f;
+
+            float     _Penetration = 0.0f;
+            glm::vec3 _Normal      {};
+    };
+};
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "ShapeMatchingKernelSimd.hpp"
+#include "Utils/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Shape matching over overlapping clusters of particles.
+    */
+    class ShapeMatchingConstraint {
+
+        public:
+
+            void Clear()
+            {
+                _ClusterOffsets.assign(1, 0);
+                _Indices.clear();
+                _RestX.clear();
+                _RestY.clear();
+                _RestZ.clear();
+                _Rotations.clear();
+                _RotationMatrices.clear();
+                _Centers.clear();
+                _MemberOffsets.clear();
+                _Members.clear();
+                _SlotClusters.clear();
+
+                _MaxClusterSize = 0;
+            }
+
+            /**
+            * @brief Adds a cluster over particles with rest shape restPositions, ignoring clusters under 2 particles.
+            */
+            void AddCluster(const std::vector<int> &particleIndices, const std::vector<glm::vec3> &restPositions)
+            {
+                if (particleIndices.size() < 2)
+                    return;
+                glm::vec3 restCenter(0.0f);
+
+                for (const auto &position : restPositions)
+                    restCenter += position;
+                restCenter /= (float)restPositions.size();
+
+                std::size_t paddedSize = (particleIndices.size() + 3) & ~std::size_t(3);
+
+                for (std::size_t k = 0; k < paddedSize; k++) {
+                    glm::vec3 offset = k < particleIndices.size() ? restPositions[k] - restCenter : glm::vec3(0.0f);
+
+                    _Indices.push_back(k < particleIndices.size() ? particleIndices[k] : -1);
+                    _RestX.push_back(offset.x);
+                    _RestY.push_back(offset.y);
+                    _RestZ.push_back(offset.z);
+                }
+
+                _ClusterOffsets.push_back((int)_Indices.size());
+                _Rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+                _RotationMatrices.push_back(glm::mat3(1.0f));
+                _Centers.push_back(restCenter);
+
+                _MaxClusterSize = std::max(_MaxClusterSize, paddedSize);
+            }
+
+            /**
+            * @brief Builds the list of cluster slots of each particle, to be called once every cluster is added.
+            */
+            void Finalize(std::size_t nbParticles)
+            {
+                _MemberOffsets.assign(nbParticles + 1, 0);
+                _SlotClusters.assign(_Indices.size(), -1);
+
+                for (std::size_t cluster = 0; cluster + 1 < _ClusterOffsets.size(); cluster++) {
+                    for (int slot = _ClusterOffsets[cluster]; slot < _ClusterOffsets[cluster + 1]; slot++) {
+                        _SlotClusters[slot] = (int)cluster;
+
+                        if (_Indices[slot] != -1)
+                            _MemberOffsets[_Indices[slot] + 1]++;
+                    }
+                }
+
+                for (std::size_t i = 0; i < nbParticles; i++)
+                    _MemberOffsets[i + 1] += _MemberOffsets[i];
+                std::vector<int> cursor(_MemberOffsets.begin(), _MemberOffsets.end() - 1);
+
+                _Members.resize(_MemberOffsets[nbParticles]);
+
+                for (std::size_t slot = 0; slot < _Indices.size(); slot++)
+                    if (_Indices[slot] != -1)
+                        _Members[cursor[_Indices[slot]]++] = (int)slot;
+            }
+
+            /**
+            * @brief Moves every particle by stiffness toward the average goal of its clusters; pinned ones stay.
+            */
+            void Solve(std::vector<glm::vec3> &positions, const std::vector<float> &inverseMasses, float stiffness)
+            {
+                if (_Rotations.empty() || stiffness <= 0.0f)
+                    return;
+                ThreadPool &pool = ThreadPool::Get();
+
+                pool.ParallelFor(_Rotations.size(), CLUSTER_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    std::vector<float> x(_MaxClusterSize), y(_MaxClusterSize), z(_MaxClusterSize);
+
+                    for (std::size_t cluster = begin; cluster < end; cluster++)
+                        MatchCluster(cluster, positions, x.data(), y.data(), z.data());
+                });
+
+                pool.ParallelFor(positions.size(), PARTICLE_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t i = begin; i < end; i++) {
+                        int first = _MemberOffsets[i], last = _MemberOffsets[i + 1];
+
+                        if (inverseMasses[i] == 0.0f || first == last)
+                            continue;
+                        glm::vec3 goal(0.0f);
+
+                        for (int member = first; member < last; member++) {
+                            int slot    = _Members[member];
+                            int cluster = _SlotClusters[slot];
+
+                            goal += _Centers[cluster] + _RotationMatrices[cluster] * glm::vec3(_RestX[slot], _RestY[slot], _RestZ[slot]);
+                        }
+
+                        goal /= (float)(last - first);
+
+                        positions[i] += stiffness * (goal - positions[i]);
+                    }
+                });
+            }
+
+            /**
+            * @brief Forgets the rotations kept from the previous solve, e.g. after the body was reset.
+            */
+            void ResetRotations()
+            {
+                std::fill(_Rotations.begin(), _Rotations.end(), glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+                std::fill(_RotationMatrices.begin(), _RotationMatrices.end(), glm::mat3(1.0f));
+            }
+
+            std::size_t Size() const
+            {
+                return _Rotations.size();
+            }
+
+        private:
+
+            void MatchCluster(std::size_t cluster, const std::vector<glm::vec3> &positions, float *x, float *y, float *z)
+            {
+                int first = _ClusterOffsets[cluster];
+                int count = _ClusterOffsets[cluster + 1] - first;
+                int size  = 0;
+
+                for (int k = 0; k < count; k++) {
+                    int index = _Indices[first + k];
+
+                    if (index == -1) {
+                        x[k] = y[k] = z[k] = 0.0f;
+
+                        continue;
+                    }
+
+                    x[k] = positions[index].x;
+                    y[k] = positions[index].y;
+                    z[k] = positions[index].z;
+
+                    size++;
+                }
+
+                glm::vec3 center = ShapeMatchingKernelSimd::Sum(x, y, z, count) / (float)size;
+                glm::mat3 moment = ShapeMatchingKernelSimd::Moment(x, y, z, center, &_RestX[first], &_RestY[first], &_RestZ[first], count);
+
+                ExtractRotation(moment, _Rotations[cluster]);
+
+                _Centers[cluster]          = center;
+                _RotationMatrices[cluster] = glm::mat3_cast(_Rotations[cluster]);
+            }
+
+            /**
+            * @brief Rotational part of the polar decomposition of a, refined in place from the previous rotation.
+            */
+            static void ExtractRotation(const glm::mat3 &a, glm::quat &rotation)
+            {
+                for (unsigned int iteration = 0; iteration < ROTATION_ITERATIONS; iteration++) {
+                    glm::mat3 r = glm::mat3_cast(rotation);
+
+                    glm::vec3 torque = glm::cross(r[0], a[0]) + glm::cross(r[1], a[1]) + glm::cross(r[2], a[2]);
+                    float     trace  = glm::dot(r[0], a[0]) + glm::dot(r[1], a[1]) + glm::dot(r[2], a[2]);
+
+                    glm::vec3 omega = torque / (std::fabs(trace) + 1e-9f);
+
+                    float angle = glm::length(omega);
+
+                    if (angle < 1e-9f)
+                        break;
+                    rotation = glm::normalize(glm::angleAxis(angle, omega / angle) * rotation);
+                }
+            }
+
+        private:
+
+            static constexpr unsigned int ROTATION_ITERATIONS = 4;
+            static constexpr std::size_t  CLUSTER_GRAIN_SIZE  = 64;
+            static constexpr std::size_t  PARTICLE_GRAIN_SIZE = 2048;
+
+            // Clusters, each padded to a multiple of 4 slots (particle -1, zero rest offset).
+            std::vector<int>   _ClusterOffsets = { 0 };
+            std::vector<int>   _Indices;
+            std::vector<float> _RestX;
+            std::vector<float> _RestY;
+            std::vector<float> _RestZ;
+
+            std::size_t _MaxClusterSize = 0;
+
+            std::vector<glm::quat> _Rotations;
+            std::vector<glm::mat3> _RotationMatrices;
+            std::vector<glm::vec3> _Centers;
+
+            // Slots of each particle, and the cluster of each slot.
+            std::vector<int> _MemberOffsets;
+            std::vector<int> _Members;
+            std::vector<int> _SlotClusters;
+    };
+};
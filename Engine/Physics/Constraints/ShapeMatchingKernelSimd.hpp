@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Utils/Simd.hpp"
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace Exodia {
+
+    /**
+    * @brief Vectorized sums over the particles of a shape matching cluster, bitwise identical to the scalar path.
+    */
+    class ShapeMatchingKernelSimd {
+
+        public:
+
+            static glm::vec3 Sum(const float *x, const float *y, const float *z, std::size_t count)
+            {
+                float sums[3][4] = {};
+
+#if defined(EXODIA_SIMD_X86)
+                if (Simd::GetLevel() >= SIMD_SSE) {
+                    __m128 sumX = _mm_setzero_ps(), sumY = _mm_setzero_ps(), sumZ = _mm_setzero_ps();
+
+                    for (std::size_t k = 0; k < count; k += 4) {
+                        sumX = _mm_add_ps(sumX, _mm_loadu_ps(x + k));
+                        sumY = _mm_add_ps(sumY, _mm_loadu_ps(y + k));
+                        sumZ = _mm_add_ps(sumZ, _mm_loadu_ps(z + k));
+                    }
+
+                    _mm_storeu_ps(sums[0], sumX);
+                    _mm_storeu_ps(sums[1], sumY);
+                    _mm_storeu_ps(sums[2], sumZ);
+
+                    return { Combine(sums[0]), Combine(sums[1]), Combine(sums[2]) };
+                }
+#endif
+
+                for (std::size_t k = 0; k < count; k += 4) {
+                    for (unsigned int lane = 0; lane < 4; lane++) {
+                        sums[0][lane] += x[k + lane];
+                        sums[1][lane] += y[k + lane];
+                        sums[2][lane] += z[k + lane];
+                    }
+                }
+
+                return { Combine(sums[0]), Combine(sums[1]), Combine(sums[2]) };
+            }
+
+            /**
+            * @brief Moment matrix sum((p_k - center) * r_k^T), r_k being the rest offsets (zero on the padding).
+            */
+            static glm::mat3 Moment(const float *x, const float *y, const float *z, glm::vec3 center, const float *restX, const float *restY, const float *restZ, std::size_t count)
+            {
+                // sums[3 * j + i] accumulates d_i * r_j, i.e. row i of column j.
+                float sums[9][4] = {};
+
+#if defined(EXODIA_SIMD_X86)
+                if (Simd::GetLevel() >= SIMD_SSE) {
+                    __m128 centerX = _mm_set1_ps(center.x), centerY = _mm_set1_ps(center.y), centerZ = _mm_set1_ps(center.z);
+
+                    __m128 moment[9];
+
+                    for (unsigned int i = 0; i < 9; i++)
+                        moment[i] = _mm_setzero_ps();
+
+                    for (std::size_t k = 0; k < count; k += 4) {
+                        __m128 d[3] = { _mm_sub_ps(_mm_loadu_ps(x + k), centerX), _mm_sub_ps(_mm_loadu_ps(y + k), centerY), _mm_sub_ps(_mm_loadu_ps(z + k), centerZ) };
+                        __m128 r[3] = { _mm_loadu_ps(restX + k), _mm_loadu_ps(restY + k), _mm_loadu_ps(restZ + k) };
+
+                        for (unsigned int j = 0; j < 3; j++)
+                            for (unsigned int i = 0; i < 3; i++)
+                                moment[3 * j + i] = _mm_add_ps(moment[3 * j + i], _mm_mul_ps(d[i], r[j]));
+                    }
+
+                    for (unsigned int i = 0; i < 9; i++)
+                        _mm_storeu_ps(sums[i], moment[i]);
+
+                    return ToMatrix(sums);
+                }
+#endif
+
+                for (std::size_t k = 0; k < count; k += 4) {
+                    for (unsigned int lane = 0; lane < 4; lane++) {
+                        float d[3] = { x[k + lane] - center.x, y[k + lane] - center.y, z[k + lane] - center.z };
+                        float r[3] = { restX[k + lane], restY[k + lane], restZ[k + lane] };
+
+                        for (unsigned int j = 0; j < 3; j++)
+                            for (unsigned int i = 0; i < 3; i++)
+                                sums[3 * j + i][lane] += d[i] * r[j];
+                    }
+                }
+
+                return ToMatrix(sums);
+            }
+
+        private:
+
+            static float Combine(const float *lanes)
+            {
+                return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            }
+
+            static glm::mat3 ToMatrix(const float (&sums)[9][4])
+            {
+                glm::mat3 matrix;
+
+                for (unsigned int j = 0; j < 3; j++)
+                    for (unsigned int i = 0; i < 3; i++)
+                        matrix[j][i] = Combine(sums[3 * j + i]);
+                return matrix;
+            }
+    };
+};
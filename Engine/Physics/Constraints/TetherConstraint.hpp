@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Constraint.hpp"
+
+#include <glm/geometric.hpp>
+#include <array>
+
+namespace Exodia {
+
+    /**
+    * @brief Fused evaluation of a tether for ConstraintBatch; only the particle moves.
+    */
+    struct TetherKernel {
+
+        static constexpr unsigned int   Arity = 1;
+        static constexpr ConstraintType Type  = INEQUALITY;
+
+        struct RestValue {
+            glm::vec3 Anchor {};
+            float     Length {};
+        };
+
+        static bool Evaluate(const std::array<glm::vec3, 1> &p, const RestValue &restValue, float &value, std::array<glm::vec3, 1> &gradient)
+        {
+            glm::vec3 direction = p[0] - restValue.Anchor;
+
+            float distance = glm::length(direction);
+
+            value = restValue.Length - distance;
+
+            if (distance < 1e-6f)
+                return false;
+            gradient[0] = -direction / distance;
+
+            return true;
+        }
+    };
+
+    /**
+    * @brief Keeps a particle within its geodesic rest distance of a pinned position.
+    */
+    class TetherConstraint : public Constraint {
+
+        public:
+
+            TetherConstraint(std::shared_ptr<Particle> p, glm::vec3 anchor, float length, float compliance) : Constraint({ p }, compliance, INEQUALITY), _RestValue({ anchor, length }) {};
+
+        public:
+
+            float Evaluate() const override
+            {
+                float value = 0.0f;
+                std::array<glm::vec3, 1> gradient;
+
+                TetherKernel::Evaluate({ _Particles[0]->PredictedPosition }, _RestValue, value, gradient);
+
+                return value;
+            }
+
+            const TetherKernel::RestValue &GetRestValue() const
+            {
+                return _RestValue;
+            }
+
+        private:
+
+            void ComputeGradient() override
+            {
+                float value = 0.0f;
+                std::array<glm::vec3, 1> gradient {};
+
+                if (!TetherKernel::Evaluate({ _Particles[0]->PredictedPosition }, _RestValue, value, gradient))
+                    gradient = {};
+                _Gradient[0] = gradient[0];
+            }
+
+            void RecomputeTargetValue() override {}
+
+        private:
+
+            TetherKernel::RestValue _RestValue;
+    };
+};
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "Constraint.hpp"
+
+#include <glm/geometric.hpp>
+#include <array>
+#include <cmath>
+
+namespace Exodia {
+
+    /**
+    * @brief Fused evaluation of an orthotropic StVK triangle strain constraint for ConstraintBatch.
+    */
+    struct TriangleStrainKernel {
+
+        static constexpr unsigned int   Arity = 3;
+        static constexpr ConstraintType Type  = EQUALITY;
+
+        struct RestValue {
+            std::array<float, 4> InverseRestMatrix {}; // Row-major 2x2.
+            float                Area              {};
+            glm::vec3            Stiffness         {}; // Warp, weft and shear.
+        };
+
+        /**
+        * @brief Builds the rest material frame, u along warpDirection projected on the triangle (its first edge when null).
+        */
+        static RestValue ComputeRestValue(const std::array<glm::vec3, 3> &p, glm::vec3 stiffness, glm::vec3 warpDirection)
+        {
+            RestValue restValue;
+
+            glm::vec3 e1 = p[1] - p[0];
+            glm::vec3 e2 = p[2] - p[0];
+
+            glm::vec3 normal = glm::cross(e1, e2);
+
+            float doubleArea = glm::length(normal);
+
+            if (doubleArea == 0.0f)
+                return restValue;
+            normal /= doubleArea;
+
+            glm::vec3 u = warpDirection - glm::dot(warpDirection, normal) * normal;
+
+            if (glm::length(u) < 1e-6f)
+                u = e1;
+            u = glm::normalize(u);
+
+            glm::vec3 v = glm::cross(normal, u);
+
+            float a = glm::dot(e1, u), b = glm::dot(e2, u);
+            float c = glm::dot(e1, v), d = glm::dot(e2, v);
+
+            float determinant = a * d - b * c;
+
+            if (determinant == 0.0f)
+                return restValue;
+            restValue.InverseRestMatrix = { d / determinant, -b / determinant, -c / determinant, a / determinant };
+            restValue.Area              = 0.5f * doubleArea;
+            restValue.Stiffness         = stiffness;
+
+            return restValue;
+        }
+
+        static bool Evaluate(const std::array<glm::vec3, 3> &p, const RestValue &restValue, float &value, std::array<glm::vec3, 3> &gradient)
+        {
+            const auto &inverse = restValue.InverseRestMatrix;
+
+            glm::vec3 e1 = p[1] - p[0];
+            glm::vec3 e2 = p[2] - p[0];
+
+            glm::vec3 fu = e1 * inverse[0] + e2 * inverse[2];
+            glm::vec3 fv = e1 * inverse[1] + e2 * inverse[3];
+
+            float strainUU = 0.5f * (glm::dot(fu, fu) - 1.0f);
+            float strainVV = 0.5f * (glm::dot(fv, fv) - 1.0f);
+            float strainUV = 0.5f * glm::dot(fu, fv);
+
+            float stressUU = restValue.Stiffness.x * strainUU;
+            float stressVV = restValue.Stiffness.y * strainVV;
+            float stressUV = restValue.Stiffness.z * strainUV;
+
+            float energy = 0.5f * restValue.Area * (stressUU * strainUU + stressVV * strainVV + 2.0f * stressUV * strainUV);
+
+            value = sqrtf(2.0f * energy);
+
+            if (value == 0.0f)
+                return false;
+
+            // dC/dx = dEnergy/dx / C, with dEnergy/d[e1, e2] = Area * F * S * InverseRestMatrix^T.
+            float scale = restValue.Area / value;
+
+            glm::vec3 pu = fu * stressUU + fv * stressUV;
+            glm::vec3 pv = fu * stressUV + fv * stressVV;
+
+            gradient[1] = scale * (pu * inverse[0] + pv * inverse[1]);
+            gradient[2] = scale * (pu * inverse[2] + pv * inverse[3]);
+            gradient[0] = -gradient[1] - gradient[2];
+
+            return true;
+        }
+    };
+
+    class TriangleStrainConstraint : public Constraint {
+
+        public:
+
+            TriangleStrainConstraint(std::shared_ptr<Particle> p0, std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, float compliance, glm::vec3 stiffness = glm::vec3(1.0f), glm::vec3 warpDirection = glm::vec3(0.0f)) : Constraint({ p0, p1, p2 }, compliance, EQUALITY), _Stiffness(stiffness), _WarpDirection(warpDirection)
+            {
+                _RestValue = TriangleStrainKernel::ComputeRestValue(Positions(&Particle::Position), _Stiffness, _WarpDirection);
+            };
+
+            TriangleStrainConstraint(std::shared_ptr<Particle> p0, std::shared_ptr<Particle> p1, std::shared_ptr<Particle> p2, float compliance, const TriangleStrainKernel::RestValue &restValue, glm::vec3 warpDirection) : Constraint({ p0, p1, p2 }, compliance, EQUALITY), _Stiffness(restValue.Stiffness), _WarpDirection(warpDirection), _RestValue(restValue) {};
+
+        public:
+
+            float Evaluate() const override
+            {
+                float value = 0.0f;
+                std::array<glm::vec3, 3> gradient;
+
+                TriangleStrainKernel::Evaluate(Positions(&Particle::PredictedPosition), _RestValue, value, gradient);
+
+                return value;
+            }
+
+            const TriangleStrainKernel::RestValue &GetRestValue() const
+            {
+                return _RestValue;
+            }
+
+            glm::vec3 GetWarpDirection() const
+            {
+                return _WarpDirection;
+            }
+
+        private:
+
+            void ComputeGradient() override
+            {
+                float value = 0.0f;
+                std::array<glm::vec3, 3> gradient {};
+
+                if (!TriangleStrainKernel::Evaluate(Positions(&Particle::PredictedPosition), _RestValue, value, gradient))
+                    gradient = {};
+                for (unsigned int i = 0; i < 3; i++)
+                    _Gradient[i] = gradient[i];
+            }
+
+            void RecomputeTargetValue() override
+            {
+                _RestValue = TriangleStrainKernel::ComputeRestValue(Positions(&Particle::Position), _Stiffness, _WarpDirection);
+            }
+
+            std::array<glm::vec3, 3> Positions(glm::vec3 Particle::*position) const
+            {
+                return { (*_Particles[0]).*position, (*_Particles[1]).*position, (*_Particles[2]).*position };
+            }
+
+        private:
+
+            glm::vec3 _Stiffness;
+            glm::vec3 _WarpDirection;
+
+            TriangleStrainKernel::RestValue _RestValue;
+    };
+};
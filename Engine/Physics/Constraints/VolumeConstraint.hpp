@@ -3,9 +3,37 @@
 #include "Constraint.hpp"
 
 #include <glm/geometric.hpp>
+#include <array>
 
 namespace Exodia {
 
+    /**
+    * @brief Fused evaluation of a tetrahedron volume constraint for ConstraintBatch.
+    */
+    struct VolumeKernel {
+
+        static constexpr unsigned int   Arity = 4;
+        static constexpr ConstraintType Type  = EQUALITY;
+
+        using RestValue = float;
+
+        static bool Evaluate(const std::array<glm::vec3, 4> &p, float restVolume, float &value, std::array<glm::vec3, 4> &gradient)
+        {
+            glm::vec3 e1 = p[1] - p[0];
+            glm::vec3 e2 = p[2] - p[0];
+            glm::vec3 e3 = p[3] - p[0];
+
+            gradient[1] = glm::cross(e2, e3) / 6.0f;
+            gradient[2] = glm::cross(e3, e1) / 6.0f;
+            gradient[3] = glm::cross(e1, e2) / 6.0f;
+            gradient[0] = -gradient[1] - gradient[2] - gradient[3];
+
+            value = glm::dot(gradient[3], e3) - restVolume;
+
+            return true;
+        }
+    };
+
     class VolumeConstraint : public Constraint {
 
         public:
@@ -26,6 +54,11 @@ namespace Exodia {
                 return glm::dot(cross, (p4 - p1)) - _RestVolume;
             }
 
+            float GetRestVolume() const
+            {
+                return _RestVolume;
+            }
+
     private:
 
         void ComputeGradient() override
@@ -20,7 +20,7 @@ namespace Exodia {
 
         std::vector<glm::vec3> ExternalForces {};
 
-        Particle(float mass, glm::vec3 initialPosition, unsigned long positionIndex) : Mass(mass), InverseMass(mass == 0 ? 0 : 1 / mass), InitialPosition(initialPosition), Position(initialPosition), PositionIndex(positionIndex) {};
+        Particle(float mass, glm::vec3 initialPosition, unsigned long positionIndex) : Mass(mass), InverseMass(mass == 0 ? 0 : 1 / mass), InitialPosition(initialPosition), Position(initialPosition), PredictedPosition(initialPosition), PositionIndex(positionIndex) {};
 
         glm::vec3 ResultingExternalForce()
         {
@@ -33,8 +33,9 @@ namespace Exodia {
 
         void Reset()
         {
-            Position = InitialPosition;
-            Velocity = glm::vec3(0, 0, 0);
+            Position          = InitialPosition;
+            PredictedPosition = InitialPosition;
+            Velocity          = glm::vec3(0, 0, 0);
         }
     };
 };
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "Mesh/Mesh.hpp"
+#include "Bodies/Body.hpp"
+#include "Solver.hpp"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Bodies prepared ahead off the solving thread and spawned into and despawned from a solver.
+    */
+    class BodyPool {
+
+        public:
+
+            /**
+            * @brief makeMesh runs on the calling thread, makeBody on the preparing ones and must not touch the GPU.
+            */
+            BodyPool(Solver &solver, std::function<std::shared_ptr<Mesh>()> makeMesh, std::function<std::shared_ptr<Body>(std::shared_ptr<Mesh>)> makeBody, std::size_t nbBodiesAhead = 4) : _Solver(solver), _MakeMesh(std::move(makeMesh)), _MakeBody(std::move(makeBody)), _NbBodiesAhead(nbBodiesAhead)
+            {
+                Refill();
+            }
+
+            ~BodyPool()
+            {
+                for (auto& pendingBody : _PendingBodies)
+                    if (pendingBody.valid())
+                        pendingBody.wait();
+            }
+
+            BodyPool(const BodyPool &) = delete;
+            BodyPool &operator=(const BodyPool &) = delete;
+
+        public:
+
+            /**
+            * @brief Adds a ready body at position to the solver, nullptr when none is ready yet (it is then on its way).
+            */
+            std::shared_ptr<Body> Spawn(glm::vec3 position)
+            {
+                CollectPreparedBodies();
+
+                if (_FreeBodies.empty()) {
+                    Refill();
+
+                    return nullptr;
+                }
+
+                auto body = std::move(_FreeBodies.back());
+
+                _FreeBodies.pop_back();
+
+                body->Respawn(position);
+                body->GetMesh()->Enabled = true;
+
+                _Solver.AddBody(body);
+
+                Refill();
+
+                return body;
+            }
+
+            /**
+            * @brief Takes the body out of the solver and keeps it for a next Spawn, false when it wasn't in the solver.
+            */
+            bool Despawn(std::shared_ptr<Body> body)
+            {
+                if (!_Solver.RemoveBody(body))
+                    return false;
+                body->GetMesh()->Enabled = false;
+
+                _FreeBodies.push_back(std::move(body));
+
+                return true;
+            }
+
+            /**
+            * @brief Starts preparing nbBodies more bodies, for a burst of spawns known in advance.
+            */
+            void Reserve(std::size_t nbBodies)
+            {
+                for (std::size_t i = 0; i < nbBodies; i++)
+                    Prepare();
+            }
+
+            std::size_t NumberOfFreeBodies()
+            {
+                CollectPreparedBodies();
+
+                return _FreeBodies.size();
+            }
+
+        private:
+
+            void Prepare()
+            {
+                auto mesh = _MakeMesh();
+
+                mesh->BakeRotationIntoGetVertex();
+                mesh->BakeScalingIntoGetVertex();
+
+                mesh->Enabled = false;
+
+                _PendingBodies.push_back(std::async(std::launch::async, [makeBody = _MakeBody, mesh]() {
+                    auto body = makeBody(mesh);
+
+                    body->Prepare();
+
+                    return body;
+                }));
+            }
+
+            /**
+            * @brief Keeps nbBodiesAhead bodies ready or being prepared.
+            */
+            void Refill()
+            {
+                for (std::size_t i = _FreeBodies.size() + _PendingBodies.size(); i < _NbBodiesAhead; i++)
+                    Prepare();
+            }
+
+            /**
+            * @brief Moves the bodies done preparing to the free ones, without waiting for the others.
+            */
+            void CollectPreparedBodies()
+            {
+                std::erase_if(_PendingBodies, [&](std::future<std::shared_ptr<Body>> &pendingBody) {
+                    if (pendingBody.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                        return false;
+                    _FreeBodies.push_back(pendingBody.get());
+
+                    return true;
+                });
+            }
+
+        private:
+
+            Solver &_Solver;
+
+            std::function<std::shared_ptr<Mesh>()>                      _MakeMesh;
+            std::function<std::shared_ptr<Body>(std::shared_ptr<Mesh>)> _MakeBody;
+
+            std::size_t _NbBodiesAhead;
+
+            std::vector<std::shared_ptr<Body>>              _FreeBodies;
+            std::vector<std::future<std::shared_ptr<Body>>> _PendingBodies;
+    };
+};
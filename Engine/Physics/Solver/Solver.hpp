@@ -4,11 +4,17 @@
 #include "Particle/Particle.hpp"
 #include "Constraints/Constraint.hpp"
 #include "Bodies/Body.hpp"
+#include "Bodies/RigidBody.hpp"
 #include "Constraints/CollisionConstraint.hpp"
+#include "Constraints/RigidContactConstraint.hpp"
+#include "Colliders/Collider.hpp"
 #include "Force/UniformAccelerationField.hpp"
+#include "Utils/ThreadPool.hpp"
 
 #include <vector>
 #include <iostream>
+#include <mutex>
+#include <unordered_map>
 
 namespace Exodia {
 
@@ -22,18 +28,43 @@ namespace Exodia {
 
     public:
 
+        /**
+        * @brief Adds a body, renumbering its particles when an ordering is set (see SetParticleOrdering).
+        */
         void AddBody(std::shared_ptr<Body> body)
         {
-            if (body->GetMass() > 0)
-                body->BuildParticleHierarchy(3);
-            else
-                body->BuildParticleHierarchy(1);
+            if (_BodySlots.contains(body.get()))
+                return;
+            body->ReorderParticles(_ParticleOrdering);
+            body->BuildParticleHierarchyAsync(body->DefaultParticleHierarchyLevels());
+
+            _BodySlots[body.get()] = _Bodies.size();
+
             _Bodies.push_back(body);
         }
 
-        void RemoveBody(std::shared_ptr<Body> body)
+        /**
+        * @brief Removes a body in constant time, the last body taking its slot. False when the body wasn't there.
+        */
+        bool RemoveBody(std::shared_ptr<Body> body)
         {
-            _Bodies.erase(std::remove(_Bodies.begin(), _Bodies.end(), body), _Bodies.end());
+            auto slot = _BodySlots.find(body.get());
+
+            if (slot == _BodySlots.end())
+                return false;
+            std::size_t index = slot->second;
+
+            _BodySlots.erase(slot);
+
+            if (index + 1 != _Bodies.size()) {
+                _Bodies[index] = std::move(_Bodies.back());
+
+                _BodySlots[_Bodies[index].get()] = index;
+            }
+
+            _Bodies.pop_back();
+
+            return true;
         }
 
         void AddField(std::shared_ptr<UniformAccelerationField> field)
@@ -46,6 +77,19 @@ namespace Exodia {
 			_Fields.erase(std::remove(_Fields.begin(), _Fields.end(), field), _Fields.end());
 		}
 
+        /**
+        * @brief Adds a static obstacle, solved in closed form against every particle and rigid vertex (see Collider).
+        */
+        void AddCollider(std::shared_ptr<Collider> collider)
+        {
+            _Colliders.push_back(collider);
+        }
+
+        void RemoveCollider(std::shared_ptr<Collider> collider)
+        {
+            _Colliders.erase(std::remove(_Colliders.begin(), _Colliders.end(), collider), _Colliders.end());
+        }
+
         void Reset()
         {
             for (const auto& body : _Bodies)
@@ -56,32 +100,49 @@ namespace Exodia {
         {
             OnBeforeSolve.NotifyObservers();
 
+            for (const auto& body : _Bodies)
+                body->WaitForParticleHierarchy();
+            auto &pool = ThreadPool::Get();
+
+            glm::vec3 rigidBodyAcceleration(0.0f);
+
+            for (const auto& field : _Fields)
+                rigidBodyAcceleration += field->ComputeAcceleration();
+
             for (const auto& body : _Bodies) {
-                if (!body->GetMesh()->Enabled)
+                if (!IsSimulated(body) || body->IsRigid())
                     continue;
-                for (const auto& particle : body->GetParticles()) {
-                    for (const auto& field : _Fields) {
+                auto &particles = body->GetParticles();
+
+                pool.ParallelFor(particles.size(), PARTICLE_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t k = begin; k < end; k++) {
+                        for (const auto& field : _Fields) {
 
-                        // F = m * a
-                        particle->ExternalForces.push_back(field->ComputeAcceleration() * particle->Mass);
+                            // F = m * a
+                            particles[k]->ExternalForces.push_back(field->ComputeAcceleration() * particles[k]->Mass);
+                        }
                     }
-                }
+                });
             }
 
             float subTimeStep = deltaTime / (float)_Iterations;
 
             for (unsigned int i = 0; i < _Iterations; i++) {
                 for (const auto& body : _Bodies) {
-                    if (!body->GetMesh()->Enabled)
+                    if (!IsSimulated(body) || body->IsRigid())
                         continue;
-                    for (const auto& particle : body->GetParticles()) {
-                        // a = F / m
-                        // v = a * t
-                        // v = t * F / m
-                        particle->Velocity += subTimeStep * particle->InverseMass * particle->ResultingExternalForce();
+                    auto &particles = body->GetParticles();
 
-                        particle->Velocity *= 0.999; // Damping, TODO: make it as a parameter
-                    }
+                    pool.ParallelFor(particles.size(), PARTICLE_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                        for (std::size_t k = begin; k < end; k++) {
+                            // a = F / m
+                            // v = a * t
+                            // v = t * F / m
+                            particles[k]->Velocity += subTimeStep * particles[k]->InverseMass * particles[k]->ResultingExternalForce();
+
+                            particles[k]->Velocity *= 0.999; // Damping, TODO: make it as a parameter
+                        }
+                    });
                 }
 
                 for (const auto& body : _Bodies) {
@@ -101,10 +162,19 @@ namespace Exodia {
                 }
 
                 for (const auto& body : _Bodies) {
-                    if (!body->GetMesh()->Enabled)
+                    if (!IsSimulated(body))
                         continue;
-                    for (const auto& particle : body->GetParticles())
-                        particle->PredictedPosition = particle->Position + subTimeStep * particle->Velocity;
+                    if (body->IsRigid()) {
+                        std::static_pointer_cast<RigidBody>(body)->Integrate(subTimeStep, rigidBodyAcceleration);
+
+                        continue;
+                    }
+                    auto &particles = body->GetParticles();
+
+                    pool.ParallelFor(particles.size(), PARTICLE_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                        for (std::size_t k = begin; k < end; k++)
+                            particles[k]->PredictedPosition = particles[k]->Position + subTimeStep * particles[k]->Velocity;
+                    });
                 }
 
                 for (const auto& body : _Bodies) {
@@ -113,168 +183,324 @@ namespace Exodia {
                     body->GetCollisionConstraints().clear();
                 }
 
-                for (int k_body = 0; k_body < _Bodies.size(); k_body++) {
-                    auto body = _Bodies[k_body];
+                _RigidContactConstraints.clear();
 
-                    if (!body->GetMesh()->Enabled)
-                        continue;
-                    glm::mat4 bodyWorld = body->GetMesh()->Transform()->ComputeWorldMatrix();
+                GenerateCollisionConstraints();
 
-                    for (int k_otherBody = k_body + 1; k_otherBody < _Bodies.size(); k_otherBody++) {
-                        auto otherBody = _Bodies[k_otherBody];
+                // Bodies are independent outside collisions.
+                pool.ParallelFor(_Bodies.size(), 1, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t k = begin; k < end; k++) {
+                        const auto &body = _Bodies[k];
 
-                        if (!otherBody->GetMesh()->Enabled)
+                        if (!IsSimulated(body) || body->IsRigid())
                             continue;
-                        glm::mat4 otherBodyWorld = otherBody->GetMesh()->Transform()->ComputeWorldMatrix();
+                        body->PackConstraints();
+                        body->GatherPredictedPositions();
+
+                        auto &positions     = body->GetPredictedPositions();
+                        auto &inverseMasses = body->GetInverseMasses();
+
+                        for (int level = body->GetDistanceBatchesPerLevel().size() - 1; level >= 0; level--)
+                            body->GetDistanceBatchesPerLevel()[level].Solve(positions, inverseMasses, subTimeStep);
+                        body->GetTriangleStrainBatch().Solve(positions, inverseMasses, subTimeStep);
+                        body->GetFastBendBatch().Solve(positions, inverseMasses, subTimeStep);
+                        body->GetDihedralBendBatch().Solve(positions, inverseMasses, subTimeStep);
+                        body->GetIsometricBendBatch().Solve(positions, inverseMasses, subTimeStep);
+                        body->GetVolumeBatch().Solve(positions, inverseMasses, subTimeStep);
+                        body->GetDeviatoricBatch().Solve(positions, inverseMasses, subTimeStep);
+                        body->GetShapeMatchingConstraint().Solve(positions, inverseMasses, body->GetShapeMatchingStiffness());
+                        body->GetTetherBatch().Solve(positions, inverseMasses, subTimeStep);
+
+                        for (const auto& attachment : body->GetAttachments())
+                            attachment->Solve(positions, inverseMasses, subTimeStep);
+                    }
+                });
+
+                // Global volumes reduce over the whole pool, one body at a time.
+                for (const auto& body : _Bodies) {
+                    if (!IsSimulated(body) || body->IsRigid())
+                        continue;
+                    for (const auto& volumeConstraint : body->GetGlobalVolumeConstraints())
+                        volumeConstraint->Solve(body->GetPredictedPositions(), body->GetInverseMasses(), subTimeStep);
+                    ProjectOnColliders(*body);
 
-                        AABB *intersection = AABB::Intersection(body->GetMesh()->GetAABB(), otherBody->GetMesh()->GetAABB());
+                    body->ScatterPredictedPositions();
+                }
+
+                // Collisions couple two bodies, they stay sequential in the order they were generated.
+                for (const auto& body : _Bodies) {
+                    if (!body->GetMesh()->Enabled)
+                        continue;
+                    for (const auto& collisionConstraint : body->GetCollisionConstraints())
+                        collisionConstraint->Solve(subTimeStep);
+                }
 
-                        if (intersection == nullptr)
+                for (const auto& body : _Bodies)
+                    if (IsSimulated(body) && body->IsRigid())
+                        std::static_pointer_cast<RigidBody>(body)->SolveAttachments(subTimeStep);
+                for (const auto& rigidContactConstraint : _RigidContactConstraints)
+                    rigidContactConstraint->Solve();
+                for (const auto& rigidContactConstraint : _RigidContactConstraints)
+                    rigidContactConstraint->SolveFriction();
+                for (const auto& body : _Bodies)
+                    if (IsSimulated(body) && body->IsRigid())
+                        std::static_pointer_cast<RigidBody>(body)->SolveColliderContacts(_Colliders);
+
+                pool.ParallelFor(_Bodies.size(), 1, [&](std::size_t begin, std::size_t end) {
+                    for (std::size_t k = begin; k < end; k++) {
+                        const auto &body = _Bodies[k];
+
+                        if (!IsSimulated(body))
                             continue;
-                        std::vector<std::shared_ptr<Particle>> bodyParticlesInIntersection;
+                        for (const auto& fixedConstraint : body->GetFixedConstraints())
+                            fixedConstraint->Solve(subTimeStep);
+                    }
+                });
 
-                        for (const auto particleIndex : body->GetParticleIndicesPerLevel()[body->GetCollisionLevel()]) {
-                            auto particle = body->GetParticles()[particleIndex];
+                for (const auto& body : _Bodies) {
+                    if (!IsSimulated(body))
+                        continue;
+                    if (body->IsRigid()) {
+                        std::static_pointer_cast<RigidBody>(body)->UpdateVelocities(subTimeStep);
 
-                            if (!intersection->Contains(particle->PredictedPosition))
-                                continue;
-                            bodyParticlesInIntersection.push_back(particle);
+                        continue;
+                    }
+                    auto &particles = body->GetParticles();
+
+                    pool.ParallelFor(particles.size(), PARTICLE_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                        for (std::size_t k = begin; k < end; k++) {
+                            particles[k]->Velocity = (particles[k]->PredictedPosition - particles[k]->Position) / subTimeStep;
+                            particles[k]->Position =  particles[k]->PredictedPosition;
                         }
+                    });
+                }
+            }
+
+            for (const auto& body : _Bodies) {
+                if (!body->GetMesh()->Enabled)
+                    continue;
+                for (const auto& particle : body->GetParticles())
+                    particle->ExternalForces.clear();
+                if (IsSimulated(body) && !body->IsRigid())
+                    body->Tear();
+                body->UpdateCollisionProxy();
+                body->UpdateVertex();
+            }
 
-                        std::vector<std::shared_ptr<Particle>> otherBodyParticlesInIntersection;
+            OnAfterSolve.NotifyObservers();
+        }
 
-                        for (const auto particleIndex : otherBody->GetParticleIndicesPerLevel()[otherBody->GetCollisionLevel()]) {
-                            auto particle = otherBody->GetParticles()[particleIndex];
+    private:
 
-                            if (!intersection->Contains(particle->PredictedPosition))
-                                continue;
-                            otherBodyParticlesInIntersection.push_back(particle);
-                        }
+        /**
+        * @brief Collision constraints of one pair of bodies, before they are handed to the bodies.
+        */
+        struct BodyPairContacts {
 
-                        std::vector<std::vector<GLint>> bodyTrianglesInIntersection;
-                        std::vector<GLint> bodyIndices = body->GetTrianglesPerLevel()[body->GetCollisionLevel()];
+            std::vector<std::shared_ptr<CollisionConstraint>>    BodyContacts;
+            std::vector<std::shared_ptr<CollisionConstraint>>    OtherBodyContacts;
+            std::vector<std::shared_ptr<RigidContactConstraint>> RigidContacts;
+        };
 
-                        for (unsigned int k = 0; k < bodyIndices.size(); k += 3) {
-                            glm::vec3 t0 = body->GetParticles()[bodyIndices[k    ]]->PredictedPosition;
-                            glm::vec3 t1 = body->GetParticles()[bodyIndices[k + 1]]->PredictedPosition;
-                            glm::vec3 t2 = body->GetParticles()[bodyIndices[k + 2]]->PredictedPosition;
+        void GenerateCollisionConstraints()
+        {
+            std::vector<std::pair<std::size_t, std::size_t>> pairs;
 
-                            if (!intersection->IntersectsTriangle(t0, t1, t2))
-                                continue;
-                            bodyTrianglesInIntersection.push_back({ bodyIndices[k], bodyIndices[k + 1], bodyIndices[k + 2] });
-                        }
+            for (std::size_t k_body = 0; k_body < _Bodies.size(); k_body++) {
+                if (!_Bodies[k_body]->GetMesh()->Enabled)
+                    continue;
+                for (std::size_t k_otherBody = k_body + 1; k_otherBody < _Bodies.size(); k_otherBody++) {
+                    if (!_Bodies[k_otherBody]->GetMesh()->Enabled)
+                        continue;
+                    if (_Bodies[k_body]->IsStatic() && _Bodies[k_otherBody]->IsStatic())
+                        continue;
+                    pairs.emplace_back(k_body, k_otherBody);
+                }
+            }
 
-                        std::vector<std::vector<GLint>> otherBodyTrianglesInIntersection;
-                        std::vector<GLint> otherBodyIndices = otherBody->GetTrianglesPerLevel()[otherBody->GetCollisionLevel()];
+            std::vector<BodyPairContacts> contactsPerPair(pairs.size());
+            std::mutex                    contactsMutex;
 
-                        for (unsigned int k = 0; k < otherBodyIndices.size(); k += 3) {
-                            glm::vec3 t0 = otherBody->GetParticles()[otherBodyIndices[k    ]]->PredictedPosition;
-                            glm::vec3 t1 = otherBody->GetParticles()[otherBodyIndices[k + 1]]->PredictedPosition;
-                            glm::vec3 t2 = otherBody->GetParticles()[otherBodyIndices[k + 2]]->PredictedPosition;
+            bool isDeterministic = ThreadPool::Get().IsDeterministic();
 
-                            if (!intersection->IntersectsTriangle(t0, t1, t2))
-                                continue;
-                            otherBodyTrianglesInIntersection.push_back({ otherBodyIndices[k], otherBodyIndices[k + 1], otherBodyIndices[k + 2] });
-                        }
+            ThreadPool::Get().ParallelFor(pairs.size(), 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = begin; k < end; k++) {
+                    auto body      = _Bodies[pairs[k].first];
+                    auto otherBody = _Bodies[pairs[k].second];
 
-                        for (const auto& particle : otherBodyParticlesInIntersection) {
-                            for (const auto& triangle : bodyTrianglesInIntersection) {
-                                float t;
+                    GenerateCollisionConstraints(body, otherBody, contactsPerPair[k]);
 
-                                glm::vec3 particleNormal = {
-                                    otherBody->GetMesh()->GetVertex().Normals[particle->PositionIndex],
-                                    otherBody->GetMesh()->GetVertex().Normals[particle->PositionIndex + 1],
-                                    otherBody->GetMesh()->GetVertex().Normals[particle->PositionIndex + 2]
-                                };
+                    if (isDeterministic)
+                        continue;
+                    std::lock_guard<std::mutex> lock(contactsMutex);
 
-                                particleNormal = glm::normalize(glm::vec3(otherBodyWorld * glm::vec4(particleNormal, 0.0f)));
+                    for (const auto& contact : contactsPerPair[k].BodyContacts)
+                        body->AddCollisionConstraint(contact);
+                    for (const auto& contact : contactsPerPair[k].OtherBodyContacts)
+                        otherBody->AddCollisionConstraint(contact);
+                    _RigidContactConstraints.insert(_RigidContactConstraints.end(), contactsPerPair[k].RigidContacts.begin(), contactsPerPair[k].RigidContacts.end());
+                }
+            });
+
+            if (!isDeterministic)
+                return;
+
+            // Handed out in body pair order.
+            for (std::size_t k = 0; k < pairs.size(); k++) {
+                for (const auto& contact : contactsPerPair[k].OtherBodyContacts)
+                    _Bodies[pairs[k].second]->AddCollisionConstraint(contact);
+                for (const auto& contact : contactsPerPair[k].BodyContacts)
+                    _Bodies[pairs[k].first]->AddCollisionConstraint(contact);
+                _RigidContactConstraints.insert(_RigidContactConstraints.end(), contactsPerPair[k].RigidContacts.begin(), contactsPerPair[k].RigidContacts.end());
+            }
+        }
 
-                                if (particle->Mass != 0 && !Utils::RayTriangleIntersection(particle->PredictedPosition - particleNormal * 0.1f, particleNormal, body->GetParticles()[triangle[0]]->PredictedPosition, body->GetParticles()[triangle[1]]->PredictedPosition, body->GetParticles()[triangle[2]]->PredictedPosition, t))
-                                    continue;
-                                if (t > 0.2f)
-                                    continue;
+        void GenerateCollisionConstraints(const std::shared_ptr<Body> &body, const std::shared_ptr<Body> &otherBody, BodyPairContacts &contacts)
+        {
+            glm::mat4 bodyWorld      = body->GetMesh()->Transform()->ComputeWorldMatrix();
+            glm::mat4 otherBodyWorld = otherBody->GetMesh()->Transform()->ComputeWorldMatrix();
 
-                                auto collisionConstraint = std::make_shared<CollisionConstraint>(particle, body->GetParticles()[triangle[0]], body->GetParticles()[triangle[1]], body->GetParticles()[triangle[2]]);
+            AABB *intersection = AABB::Intersection(body->GetMesh()->GetAABB(), otherBody->GetMesh()->GetAABB());
 
-                                otherBody->AddCollisionConstraint(collisionConstraint);
-                            }
-                        }
+            if (intersection == nullptr)
+                return;
+            std::vector<std::shared_ptr<Particle>> bodyParticlesInIntersection;
 
-                        for (const auto& particle : bodyParticlesInIntersection) {
-                            for (const auto& triangle : otherBodyTrianglesInIntersection) {
-                                float t;
+            for (const auto particleIndex : body->GetCollisionParticles()) {
+                auto particle = body->GetParticles()[particleIndex];
 
-                                glm::vec3 particleNormal = {
-                                    body->GetMesh()->GetVertex().Normals[particle->PositionIndex    ],
-                                    body->GetMesh()->GetVertex().Normals[particle->PositionIndex + 1],
-                                    body->GetMesh()->GetVertex().Normals[particle->PositionIndex + 2]
-                                };
+                if (!intersection->Contains(particle->PredictedPosition))
+                    continue;
+                bodyParticlesInIntersection.push_back(particle);
+            }
 
-                                particleNormal = glm::normalize(glm::vec3(bodyWorld * glm::vec4(particleNormal, 0.0f)));
+            std::vector<std::shared_ptr<Particle>> otherBodyParticlesInIntersection;
 
-                                if (particle->Mass != 0 && !Utils::RayTriangleIntersection(particle->PredictedPosition - particleNormal * 0.1f, particleNormal, otherBody->GetParticles()[triangle[0]]->PredictedPosition, otherBody->GetParticles()[triangle[1]]->PredictedPosition, otherBody->GetParticles()[triangle[2]]->PredictedPosition, t))
-                                    continue;
-                                if (t > 0.2f)
-                                    continue;
+            for (const auto particleIndex : otherBody->GetCollisionParticles()) {
+                auto particle = otherBody->GetParticles()[particleIndex];
 
-                                auto collisionConstraint = std::make_shared<CollisionConstraint>(particle, otherBody->GetParticles()[triangle[0]], otherBody->GetParticles()[triangle[1]], otherBody->GetParticles()[triangle[2]]);
+                if (!intersection->Contains(particle->PredictedPosition))
+                    continue;
+                otherBodyParticlesInIntersection.push_back(particle);
+            }
 
-                                body->AddCollisionConstraint(collisionConstraint);
-                            }
-                        }
+            std::vector<std::vector<GLint>> bodyTrianglesInIntersection;
+            const std::vector<GLint> &bodyIndices = body->GetCollisionTriangles();
 
-                        delete intersection;
-                    }
-                }
+            for (unsigned int k = 0; k < bodyIndices.size(); k += 3) {
+                glm::vec3 t0 = body->GetParticles()[bodyIndices[k    ]]->PredictedPosition;
+                glm::vec3 t1 = body->GetParticles()[bodyIndices[k + 1]]->PredictedPosition;
+                glm::vec3 t2 = body->GetParticles()[bodyIndices[k + 2]]->PredictedPosition;
 
-                for (const auto& body : _Bodies) {
-                    if (!body->GetMesh()->Enabled)
+                if (!intersection->IntersectsTriangle(t0, t1, t2))
+                    continue;
+                bodyTrianglesInIntersection.push_back({ bodyIndices[k], bodyIndices[k + 1], bodyIndices[k + 2] });
+            }
+
+            std::vector<std::vector<GLint>> otherBodyTrianglesInIntersection;
+            const std::vector<GLint> &otherBodyIndices = otherBody->GetCollisionTriangles();
+
+            for (unsigned int k = 0; k < otherBodyIndices.size(); k += 3) {
+                glm::vec3 t0 = otherBody->GetParticles()[otherBodyIndices[k    ]]->PredictedPosition;
+                glm::vec3 t1 = otherBody->GetParticles()[otherBodyIndices[k + 1]]->PredictedPosition;
+                glm::vec3 t2 = otherBody->GetParticles()[otherBodyIndices[k + 2]]->PredictedPosition;
+
+                if (!intersection->IntersectsTriangle(t0, t1, t2))
+                    continue;
+                otherBodyTrianglesInIntersection.push_back({ otherBodyIndices[k], otherBodyIndices[k + 1], otherBodyIndices[k + 2] });
+            }
+
+            for (const auto& particle : otherBodyParticlesInIntersection) {
+                for (const auto& triangle : bodyTrianglesInIntersection) {
+                    float t;
+
+                    glm::vec3 particleNormal = otherBody->GetParticleNormals()[particle->PositionIndex / 3];
+
+                    particleNormal = glm::normalize(glm::vec3(otherBodyWorld * glm::vec4(particleNormal, 0.0f)));
+
+                    if ((particle->Mass != 0 || body->IsRigid()) && !Utils::RayTriangleIntersection(particle->PredictedPosition - particleNormal * 0.1f, particleNormal, body->GetParticles()[triangle[0]]->PredictedPosition, body->GetParticles()[triangle[1]]->PredictedPosition, body->GetParticles()[triangle[2]]->PredictedPosition, t))
+                        continue;
+                    if (t > 0.2f)
                         continue;
-                    for (int level = body->GetDistanceConstraintsPerLevel().size() - 1; level >= 0; level--) {
-                        auto distanceConstraints = body->GetDistanceConstraintsPerLevel()[level];
+                    if (body->IsRigid()) {
+                        contacts.RigidContacts.push_back(MakeRigidContactConstraint(otherBody, particle, body, triangle));
 
-                        for (const auto& distanceConstraint : distanceConstraints)
-                            distanceConstraint->Solve(subTimeStep);
+                        continue;
                     }
-
-                    for (const auto& fastBendConstraint : body->GetFastBendConstraints())
-                        fastBendConstraint->Solve(subTimeStep);
-                    for (const auto& diheralConstraint : body->GetDihedralBendConstraints())
-                        diheralConstraint->Solve(subTimeStep);
-                    for (const auto& volumeConstraint : body->GetVolumeConstraints())
-                        volumeConstraint->Solve(subTimeStep);
-                    for (const auto& volumeConstraint : body->GetGlobalVolumeConstraints())
-                        volumeConstraint->Solve(subTimeStep);
-                    for (const auto& collisionConstraint : body->GetCollisionConstraints())
-                        collisionConstraint->Solve(subTimeStep);
-                    for (const auto& fixedConstraint : body->GetFixedConstraints())
-                        fixedConstraint->Solve(subTimeStep);
+                    contacts.OtherBodyContacts.push_back(std::make_shared<CollisionConstraint>(particle, body->GetParticles()[triangle[0]], body->GetParticles()[triangle[1]], body->GetParticles()[triangle[2]]));
                 }
+            }
+
+            for (const auto& particle : bodyParticlesInIntersection) {
+                for (const auto& triangle : otherBodyTrianglesInIntersection) {
+                    float t;
+
+                    glm::vec3 particleNormal = body->GetParticleNormals()[particle->PositionIndex / 3];
+
+                    particleNormal = glm::normalize(glm::vec3(bodyWorld * glm::vec4(particleNormal, 0.0f)));
+
+                    if ((particle->Mass != 0 || otherBody->IsRigid()) && !Utils::RayTriangleIntersection(particle->PredictedPosition - particleNormal * 0.1f, particleNormal, otherBody->GetParticles()[triangle[0]]->PredictedPosition, otherBody->GetParticles()[triangle[1]]->PredictedPosition, otherBody->GetParticles()[triangle[2]]->PredictedPosition, t))
+                        continue;
+                    if (t > 0.2f)
+                        continue;
+                    if (otherBody->IsRigid()) {
+                        contacts.RigidContacts.push_back(MakeRigidContactConstraint(body, particle, otherBody, triangle));
 
-                for (const auto& body : _Bodies) {
-                    if (!body->GetMesh()->Enabled)
                         continue;
-                    for (const auto& particle : body->GetParticles()) {
-                        particle->Velocity = (particle->PredictedPosition - particle->Position) / subTimeStep;
-                        particle->Position =  particle->PredictedPosition;
                     }
+                    contacts.BodyContacts.push_back(std::make_shared<CollisionConstraint>(particle, otherBody->GetParticles()[triangle[0]], otherBody->GetParticles()[triangle[1]], otherBody->GetParticles()[triangle[2]]));
                 }
             }
 
-            for (const auto& body : _Bodies) {
-                if (!body->GetMesh()->Enabled)
-                    continue;
-                for (const auto& particle : body->GetParticles())
-                    particle->ExternalForces.clear();
-                body->UpdateVertex();
-            }
+            delete intersection;
+        }
 
-            OnAfterSolve.NotifyObservers();
+        /**
+        * @brief Contact of a particle of pointBody, or a vertex when it is rigid, against a rigid body's triangle.
+        */
+        static std::shared_ptr<RigidContactConstraint> MakeRigidContactConstraint(const std::shared_ptr<Body> &pointBody, const std::shared_ptr<Particle> &particle, const std::shared_ptr<Body> &body, const std::vector<GLint> &triangle)
+        {
+            auto rigidBody = std::static_pointer_cast<RigidBody>(body);
+
+            std::array<int, 3> indices = { triangle[0], triangle[1], triangle[2] };
+
+            if (!pointBody->IsRigid())
+                return std::make_shared<RigidContactConstraint>(particle, rigidBody, indices);
+            return std::make_shared<RigidContactConstraint>(std::static_pointer_cast<RigidBody>(pointBody), (int)(particle->PositionIndex / 3), rigidBody, indices);
+        }
+
+        /**
+        * @brief Whether the body takes part in the substeps; static bodies only collide.
+        */
+        static bool IsSimulated(const std::shared_ptr<Body> &body)
+        {
+            return body->GetMesh()->Enabled && !body->IsStatic();
+        }
+
+        /**
+        * @brief Projects the gathered predicted positions of a body out of the colliders, each particle on its own.
+        */
+        void ProjectOnColliders(Body &body)
+        {
+            if (_Colliders.empty())
+                return;
+            auto &particles     = body.GetParticles();
+            auto &positions     = body.GetPredictedPositions();
+            auto &inverseMasses = body.GetInverseMasses();
+
+            ThreadPool::Get().ParallelFor(positions.size(), PARTICLE_GRAIN_SIZE, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; i++) {
+                    if (inverseMasses[i] == 0.0f)
+                        continue;
+                    for (const auto& collider : _Colliders)
+                        collider->Project(positions[i], particles[i]->Position);
+                }
+            });
         }
 
         public:
 
-            std::vector<std::shared_ptr<Body>>& GetBodies()
+            const std::vector<std::shared_ptr<Body>>& GetBodies() const
             {
                 return _Bodies;
             }
@@ -294,6 +520,19 @@ namespace Exodia {
                 _Iterations = iterations;
             }
 
+            /**
+            * @brief Order the particles of bodies added from now on are renumbered to, none by default.
+            */
+            void SetParticleOrdering(ParticleOrdering ordering)
+            {
+                _ParticleOrdering = ordering;
+            }
+
+            ParticleOrdering GetParticleOrdering() const
+            {
+                return _ParticleOrdering;
+            }
+
         public:
 
             Observable<> OnBeforeSolve;
@@ -301,9 +540,17 @@ namespace Exodia {
   
         private:
 
+            static constexpr std::size_t PARTICLE_GRAIN_SIZE = 2048;
+
             int _Iterations = 4;
 
+            ParticleOrdering _ParticleOrdering = ORDERING_NONE;
+
             std::vector<std::shared_ptr<Body>>                     _Bodies;
+            std::unordered_map<const Body *, std::size_t>          _BodySlots;
             std::vector<std::shared_ptr<UniformAccelerationField>> _Fields;
+            std::vector<std::shared_ptr<Collider>>                 _Colliders;
+
+            std::vector<std::shared_ptr<RigidContactConstraint>> _RigidContactConstraints;
     };
 };
@@ -2,3 +2,5 @@
 
 int Exodia::Settings::MAX_POINT_LIGHTS       = 128;
 int Exodia::Settings::MAX_DIRECTIONAL_LIGHTS = 128;
+
+Exodia::AnglePrecision Exodia::Settings::DIHEDRAL_ANGLE_PRECISION = Exodia::ANGLE_PRECISION_EXACT;
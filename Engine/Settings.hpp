@@ -2,11 +2,18 @@
 
 namespace Exodia {
 
+    enum AnglePrecision {
+        ANGLE_PRECISION_EXACT,
+        ANGLE_PRECISION_FAST
+    };
+
     class Settings {
 
         public:
 
             static int MAX_POINT_LIGHTS;
             static int MAX_DIRECTIONAL_LIGHTS;
+
+            static AnglePrecision DIHEDRAL_ANGLE_PRECISION;
     };
 };
@@ -0,0 +1,84 @@
+#pragma once
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    #define EXODIA_SIMD_X86
+
+    #include <immintrin.h>
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+
+        #define EXODIA_TARGET_AVX2
+    #else
+        #define EXODIA_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace Exodia {
+
+    enum SimdLevel {
+        SIMD_SCALAR,
+        SIMD_SSE,
+        SIMD_AVX2
+    };
+
+    /**
+    * @brief Runtime detection of the vector instruction sets the kernels can dispatch to.
+    */
+    class Simd {
+
+        public:
+
+            static SimdLevel GetLevel()
+            {
+                static SimdLevel supportedLevel = DetectLevel();
+
+                return MaxLevel() < supportedLevel ? MaxLevel() : supportedLevel;
+            }
+
+            /**
+            * @brief Caps the level returned by GetLevel, e.g. to compare a vector kernel with its scalar fallback.
+            */
+            static void SetMaxLevel(SimdLevel level)
+            {
+                MaxLevel() = level;
+            }
+
+        private:
+
+            static SimdLevel &MaxLevel()
+            {
+                static SimdLevel maxLevel = SIMD_AVX2;
+
+                return maxLevel;
+            }
+
+            static SimdLevel DetectLevel()
+            {
+#if !defined(EXODIA_SIMD_X86)
+                return SIMD_SCALAR;
+#elif defined(_MSC_VER) && !defined(__clang__)
+                int info[4];
+
+                __cpuid(info, 0);
+
+                if (info[0] < 7)
+                    return SIMD_SSE;
+                __cpuid(info, 1);
+
+                bool hasOsXSave = (info[2] & (1 << 27)) != 0;
+                bool hasAvx     = (info[2] & (1 << 28)) != 0;
+
+                if (!hasOsXSave || !hasAvx || (_xgetbv(0) & 6) != 6)
+                    return SIMD_SSE;
+                __cpuidex(info, 7, 0);
+
+                return (info[1] & (1 << 5)) != 0 ? SIMD_AVX2 : SIMD_SSE;
+#else
+                __builtin_cpu_init();
+
+                return __builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_SSE;
+#endif
+            }
+    };
+};
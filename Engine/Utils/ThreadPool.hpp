@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Exodia {
+
+    /**
+    * @brief Worker threads splitting loops into chunks, shared by the whole process (see Get).
+    */
+    class ThreadPool {
+
+        public:
+
+            static ThreadPool &Get()
+            {
+                static ThreadPool instance(std::max(1u, std::thread::hardware_concurrency()) - 1);
+
+                return instance;
+            }
+
+        public:
+
+            explicit ThreadPool(unsigned int nbWorkers)
+            {
+                StartWorkers(nbWorkers);
+            }
+
+            ~ThreadPool()
+            {
+                StopWorkers();
+            }
+
+            ThreadPool(const ThreadPool &) = delete;
+            ThreadPool &operator=(const ThreadPool &) = delete;
+
+        public:
+
+            /**
+            * @brief Calls function(begin, end) over [0, count) split in chunks of grainSize, and blocks until all of them are done.
+            */
+            void ParallelFor(std::size_t count, std::size_t grainSize, const std::function<void(std::size_t, std::size_t)> &function)
+            {
+                if (count == 0)
+                    return;
+                grainSize = std::max<std::size_t>(grainSize, 1);
+
+                std::size_t nbChunks = (count + grainSize - 1) / grainSize;
+
+                if (_Workers.empty() || nbChunks == 1 || IsInsideJob() || !_JobMutex.try_lock()) {
+                    for (std::size_t begin = 0; begin < count; begin += grainSize)
+                        function(begin, std::min(begin + grainSize, count));
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(_Mutex);
+
+                    _Function     = &function;
+                    _Count        = count;
+                    _GrainSize    = grainSize;
+                    _NbChunks     = nbChunks;
+                    _NbDoneChunks = 0;
+                    _Exception    = nullptr;
+                    _NextChunk.store(0);
+                    _IsJobFailing.store(false);
+                    _Generation++;
+                }
+
+                std::exception_ptr exception;
+
+                {
+                    JobGuard guard { *this, exception };
+
+                    _WakeUp.notify_all();
+
+                    IsInsideJob() = true;
+
+                    RunChunks();
+                }
+
+                if (exception)
+                    std::rethrow_exception(exception);
+            }
+
+            /**
+            * @brief Maps every chunk of [0, count) to a partial result with map(begin, end), then folds the partials in chunk order.
+            */
+            template<typename T, typename MapFunction, typename CombineFunction>
+            T ParallelReduce(std::size_t count, std::size_t grainSize, T identity, MapFunction map, CombineFunction combine)
+            {
+                if (count == 0)
+                    return identity;
+                grainSize = std::max<std::size_t>(grainSize, 1);
+
+                if (!_Deterministic)
+                    grainSize = std::max(grainSize, (count + _Workers.size()) / (_Workers.size() + 1));
+                std::size_t nbChunks = (count + grainSize - 1) / grainSize;
+
+                std::vector<T> partials(nbChunks, identity);
+
+                ParallelFor(count, grainSize, [&](std::size_t begin, std::size_t end) {
+                    partials[begin / grainSize] = map(begin, end);
+                });
+
+                T result = identity;
+
+                for (const auto &partial : partials)
+                    result = combine(result, partial);
+                return result;
+            }
+
+        public:
+
+            /**
+            * @brief Number of threads helping the calling thread (0 runs everything on the calling thread).
+            */
+            void SetWorkerCount(unsigned int nbWorkers)
+            {
+                std::lock_guard<std::mutex> jobLock(_JobMutex);
+
+                StopWorkers();
+                StartWorkers(nbWorkers);
+            }
+
+            unsigned int GetWorkerCount() const
+            {
+                return (unsigned int)_Workers.size();
+            }
+
+            /**
+            * @brief Makes results bitwise identical whatever the worker count.
+            */
+            void SetDeterministic(bool deterministic)
+            {
+                _Deterministic = deterministic;
+            }
+
+            bool IsDeterministic() const
+            {
+                return _Deterministic;
+            }
+
+        private:
+
+            /**
+            * @brief Releases the pool however the calling thread leaves its job, once the workers are done with it.
+            */
+            struct JobGuard {
+
+                ThreadPool         &Pool;
+                std::exception_ptr &Exception;
+
+                ~JobGuard()
+                {
+                    IsInsideJob() = false;
+
+                    {
+                        std::unique_lock<std::mutex> lock(Pool._Mutex);
+
+                        Pool._Finished.wait(lock, [&]() { return Pool._NbDoneChunks == Pool._NbChunks && Pool._NbActiveWorkers == 0; });
+
+                        Pool._Function = nullptr;
+                        Exception      = std::exchange(Pool._Exception, nullptr);
+                    }
+
+                    Pool._JobMutex.unlock();
+                }
+            };
+
+            void StartWorkers(unsigned int nbWorkers)
+            {
+                _Stopping = false;
+
+                for (unsigned int i = 0; i < nbWorkers; i++)
+                    _Workers.emplace_back([this]() { WorkerLoop(); });
+            }
+
+            void StopWorkers()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(_Mutex);
+
+                    _Stopping = true;
+                }
+
+                _WakeUp.notify_all();
+
+                for (auto &worker : _Workers)
+                    worker.join();
+                _Workers.clear();
+            }
+
+            void WorkerLoop()
+            {
+                IsInsideJob() = true;
+
+                unsigned long long seenGeneration = 0;
+
+                while (true) {
+                    {
+                        std::unique_lock<std::mutex> lock(_Mutex);
+
+                        _WakeUp.wait(lock, [&]() { return _Stopping || _Generation != seenGeneration; });
+
+                        if (_Stopping)
+                            return;
+                        seenGeneration = _Generation;
+
+                        if (_Function == nullptr)
+                            continue;
+                        _NbActiveWorkers++;
+                    }
+
+                    RunChunks();
+
+                    {
+                        std::lock_guard<std::mutex> lock(_Mutex);
+
+                        _NbActiveWorkers--;
+                    }
+
+                    _Finished.notify_all();
+                }
+            }
+
+            void RunChunks()
+            {
+                std::size_t nbDone = 0;
+
+                for (std::size_t chunk = _NextChunk.fetch_add(1); chunk < _NbChunks; chunk = _NextChunk.fetch_add(1)) {
+                    std::size_t begin = chunk * _GrainSize;
+
+                    // Once a chunk threw, the others are only counted, so that the job still ends.
+                    if (!_IsJobFailing.load()) {
+                        try {
+                            (*_Function)(begin, std::min(begin + _GrainSize, _Count));
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(_Mutex);
+
+                            if (!_Exception)
+                                _Exception = std::current_exception();
+                            _IsJobFailing.store(true);
+                        }
+                    }
+
+                    nbDone++;
+                }
+
+                if (nbDone == 0)
+                    return;
+                std::lock_guard<std::mutex> lock(_Mutex);
+
+                _NbDoneChunks += nbDone;
+            }
+
+            /**
+            * @brief True on the workers, and on the calling thread while it runs chunks (it already owns the pool).
+            */
+            static bool &IsInsideJob()
+            {
+                thread_local bool isInsideJob = false;
+
+                return isInsideJob;
+            }
+
+        private:
+
+            std::vector<std::thread> _Workers;
+
+            std::mutex              _JobMutex;
+            std::mutex              _Mutex;
+            std::condition_variable _WakeUp;
+            std::condition_variable _Finished;
+
+            const std::function<void(std::size_t, std::size_t)> *_Function = nullptr;
+
+            std::exception_ptr _Exception;
+            std::atomic<bool>  _IsJobFailing = false;
+
+            std::size_t              _Count           = 0;
+            std::size_t              _GrainSize       = 1;
+            std::size_t              _NbChunks        = 0;
+            std::size_t              _NbDoneChunks    = 0;
+            std::atomic<std::size_t> _NextChunk       = 0;
+            unsigned int             _NbActiveWorkers = 0;
+            unsigned long long       _Generation      = 0;
+
+            bool _Stopping      = false;
+            bool _Deterministic = true;
+    };
+};
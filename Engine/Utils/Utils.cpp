@@ -6,9 +6,12 @@
 #include <fstream>
 #include <iostream>
 #include <vector>
+#include <cstdint>
+#include <unordered_map>
 #include <glm/vec4.hpp>
 
 #include "Utils.hpp"
+#include "Mesh/Topology.hpp"
 
 namespace Exodia {
 
@@ -117,40 +120,70 @@ namespace Exodia {
 
     void Utils::MergeVertices(std::vector<float>& positions, std::vector<int>& indices)
     {
-        std::vector<float> newPositions;
-        std::vector<int>   newIndices;
+        std::vector<float> mergedPositions;
+        std::vector<int>   mergedIndices = WeldVertices(positions, mergedPositions);
 
-        for (int i = 0; i < positions.size(); i += 3) {
-            glm::vec3 vertex = { positions[i], positions[i + 1], positions[i + 2] };
+        for (int& index : indices)
+            index = mergedIndices[index];
+        positions = std::move(mergedPositions);
+    }
+
+    /**
+    * @brief Merges vertices closer than weldDistance and returns the welded vertex of each one.
+    */
+    std::vector<int> Utils::WeldVertices(const std::vector<float>& positions, std::vector<float>& weldedPositions, float weldDistance)
+    {
+        std::size_t nbVertices = positions.size() / 3;
+
+        std::vector<int>                        weldedIndices(nbVertices, -1);
+        std::vector<int>                        nextInCell;
+        std::unordered_map<std::uint64_t, int> firstInCell;
 
-            bool isDuplicated = false;
-            int originalIndex = -1;
+        auto cellKey = [](glm::ivec3 cell) {
+            return ((std::uint64_t)(cell.x & 0x1FFFFF) << 42) | ((std::uint64_t)(cell.y & 0x1FFFFF) << 21) | (std::uint64_t)(cell.z & 0x1FFFFF);
+        };
 
-            for (int j = 0; j < positions.size() - 3; j += 3) {
-                glm::vec3 otherVertex = { positions[j], positions[j + 1], positions[j + 2] };
+        float cellSize = 2.0f * weldDistance;
 
-                if (glm::distance(vertex, otherVertex) < 0.001f) {
-                    isDuplicated  = true;
-                    originalIndex = j;
+        weldedPositions.clear();
+        firstInCell.reserve(nbVertices);
 
-                    break;
+        for (std::size_t v = 0; v < nbVertices; v++) {
+            glm::vec3 position = { positions[3 * v], positions[3 * v + 1], positions[3 * v + 2] };
+            glm::vec3 scaled   = position / cellSize;
+
+            glm::ivec3 cell = glm::ivec3(glm::floor(scaled));
+            glm::ivec3 side = glm::ivec3(glm::step(glm::vec3(0.5f), scaled - glm::floor(scaled))) * 2 - 1;
+
+            for (int k = 0; k < 8 && weldedIndices[v] == -1; k++) {
+                auto found = firstInCell.find(cellKey(cell + glm::ivec3(k & 1, (k >> 1) & 1, (k >> 2) & 1) * side));
+
+                if (found == firstInCell.end())
+                    continue;
+                for (int welded = found->second; welded != -1; welded = nextInCell[welded]) {
+                    glm::vec3 weldedPosition = { weldedPositions[3 * welded], weldedPositions[3 * welded + 1], weldedPositions[3 * welded + 2] };
+
+                    if (glm::distance(weldedPosition, position) < weldDistance) {
+                        weldedIndices[v] = welded;
+
+                        break;
+                    }
                 }
             }
 
-            if (!isDuplicated)
+            if (weldedIndices[v] != -1)
                 continue;
-            if (i / 3 == originalIndex / 3)
-                continue;
-            for (int j = 0; j < indices.size(); j++)
-                if (indices[j] == i / 3)
-                    indices[j] = originalIndex / 3;
-            for (int j = 0; j < indices.size(); j++)
-                if (indices[j] > i / 3)
-                    indices[j]--;
-            positions.erase(positions.begin() + i, positions.begin() + i + 3);
-
-            i -= 3;
+            weldedIndices[v] = (int)nextInCell.size();
+
+            auto [first, isNew] = firstInCell.try_emplace(cellKey(cell), weldedIndices[v]);
+
+            nextInCell.push_back(isNew ? -1 : first->second);
+            first->second = weldedIndices[v];
+
+            weldedPositions.insert(weldedPositions.end(), { position.x, position.y, position.z });
         }
+
+        return weldedIndices;
     }
 
     bool Utils::RayTriangleIntersection(glm::vec3 rayOrigin, glm::vec3 rayDirection, glm::vec3 t0, glm::vec3 t1, glm::vec3 t2, float& t)
@@ -184,23 +217,51 @@ namespace Exodia {
         return false;
     }
 
-    bool Utils::IsTriangulationClosed(std::vector<int>& indices)
+    /**
+    * @brief Closest point of triangle abc to p.
+    */
+    glm::vec3 Utils::ClosestPointOnTriangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c)
     {
-        std::map<std::pair<int, int>, int> edgeCount;
+        glm::vec3 ab = b - a, ac = c - a, ap = p - a;
 
-        for (int i = 0; i < indices.size(); i += 3) {
-            int v1 = indices[i    ];
-            int v2 = indices[i + 1];
-            int v3 = indices[i + 2];
+        float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
 
-            edgeCount[std::make_pair(std::min(v1, v2), std::max(v1, v2))]++;
-            edgeCount[std::make_pair(std::min(v2, v3), std::max(v2, v3))]++;
-            edgeCount[std::make_pair(std::min(v1, v3), std::max(v1, v3))]++;
-        }
+        if (d1 <= 0.0f && d2 <= 0.0f)
+            return a;
+        glm::vec3 bp = p - b;
+
+        float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+
+        if (d3 >= 0.0f && d4 <= d3)
+            return b;
+        float vc = d1 * d4 - d3 * d2;
+
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+            return a + (d1 / (d1 - d3)) * ab;
+        glm::vec3 cp = p - c;
+
+        float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+
+        if (d6 >= 0.0f && d5 <= d6)
+            return c;
+        float vb = d5 * d2 - d1 * d6;
+
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+            return a + (d2 / (d2 - d6)) * ac;
+        float va = d3 * d6 - d5 * d4;
+
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+            return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+        float denominator = 1.0f / (va + vb + vc);
+
+        return a + ab * (vb * denominator) + ac * (vc * denominator);
+    }
+
+    bool Utils::IsTriangulationClosed(std::vector<int>& indices)
+    {
+        int nbVertices = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1;
 
-        return std::all_of(edgeCount.begin(), edgeCount.end(), [](std::pair<std::pair<int, int>, int> edge) {
-            return edge.second == 2;
-        });
+        return Topology(indices, nbVertices).IsClosed();
     }
 
     bool Utils::IsMergedTriangulationClosed(std::vector<int>& indices, std::vector<float>& positions)
@@ -26,8 +26,12 @@ namespace Exodia {
 
         static void MergeVertices(std::vector<float>& positions, std::vector<int>& indices);
 
+        static std::vector<int> WeldVertices(const std::vector<float>& positions, std::vector<float>& weldedPositions, float weldDistance = 0.001f);
+
         static bool RayTriangleIntersection(glm::vec3 rayOrigin, glm::vec3 rayDirection, glm::vec3 t0, glm::vec3 t1, glm::vec3 t2, float& t);
 
+        static glm::vec3 ClosestPointOnTriangle(glm::vec3 p, glm::vec3 a, glm::vec3 b, glm::vec3 c);
+
         static bool IsTriangulationClosed(std::vector<int>& indices);
 
         static bool IsMergedTriangulationClosed(std::vector<int>& indices, std::vector<float>& positions);